@@ -0,0 +1,69 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "CaselessSearch.h"
+
+#include <bit>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr bool IsUpper(char c) { return (c >= 'A' && c <= 'Z'); }
+constexpr bool IsLower(char c) { return (c >= 'a' && c <= 'z'); }
+constexpr char ToLower(char c) { return IsUpper(c) ? char(c | 0x20) : c; }
+
+} // local
+
+CaselessSearch::CaselessSearch(std::string_view pattern) : pat{pattern} {
+  for (auto& c: pat)
+    c = ToLower(c);
+} // ctor
+
+bool CaselessSearch::matches(const char* text) const {
+  for (std::size_t i = 0; i != pat.size(); ++i) {
+    if (ToLower(text[i]) != pat[i])
+      return false;
+  }
+  return true;
+} // matches
+
+std::size_t CaselessSearch::find(std::string_view text,
+				 std::size_t pos) const
+{
+  const auto n = pat.size();
+  if (text.size() < n || pos > text.size() - n)
+    return npos;
+  if (n == 0)
+    return pos;
+  const auto last = text.size() - n;  // where a match can start
+  const char* s = text.data();
+#if defined(__SSE2__)
+  // A letter matches either case by setting the 0x20 bit of the text.
+  auto fold = [](char c) { return char(IsLower(c) ? 0x20 : 0); };
+  const auto first_or  = _mm_set1_epi8(fold(pat.front()));
+  const auto first_cmp = _mm_set1_epi8(pat.front());
+  const auto last_or   = _mm_set1_epi8(fold(pat.back()));
+  const auto last_cmp  = _mm_set1_epi8(pat.back());
+  for (; pos + 15 <= last; pos += 16) {
+    auto head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + pos));
+    auto tail = _mm_loadu_si128(
+		    reinterpret_cast<const __m128i*>(s + pos + n - 1));
+    auto eq = _mm_and_si128(
+		_mm_cmpeq_epi8(_mm_or_si128(head, first_or), first_cmp),
+		_mm_cmpeq_epi8(_mm_or_si128(tail, last_or), last_cmp));
+    for (auto mask = unsigned(_mm_movemask_epi8(eq)); mask != 0;
+	 mask &= mask - 1)
+    {
+      const auto i = pos + std::countr_zero(mask);
+      if (matches(s + i))
+	return i;
+    }
+  }
+#endif
+  for (; pos <= last; ++pos) {
+    if (matches(s + pos))
+      return pos;
+  }
+  return npos;
+} // find
@@ -0,0 +1,26 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef CASELESS_SEARCH_H
+#define CASELESS_SEARCH_H
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Finds a fixed string in text, ignoring ASCII case.  Candidates are found
+// 16 bytes at a time, by the pattern's first and last characters, with
+// SSE2 where there is SSE2, and then compared in full.
+class CaselessSearch {
+  std::string pat;  // lower case
+  bool matches(const char* text) const;
+public:
+  static constexpr auto npos = std::string_view::npos;
+  explicit CaselessSearch(std::string_view pattern);
+  const std::string& pattern() const { return pat; }
+  std::size_t size() const { return pat.size(); }
+  // The first match in text at or after pos, or npos.
+  std::size_t find(std::string_view text, std::size_t pos = 0) const;
+  bool in(std::string_view text) const { return (find(text) != npos); }
+}; // CaselessSearch
+
+#endif
@@ -0,0 +1,79 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef COMPLETE_H
+#define COMPLETE_H
+#pragma once
+
+#include "FoldCase.h"
+
+#include <gsl/gsl>
+
+#include <string_view>
+#include <vector>
+#include <ranges>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+
+// Prefix completion over a sorted table of strings, such as ingred.dat's
+// names or usda_foods.bin's descriptions in description order.  The table
+// is the index: two binary searches find the keys that start with the
+// prefix, and one pass over them keeps the best in a heap.
+
+constexpr char SameCase(char c) { return c; }
+
+// lhs < rhs as std::string_view compares them, after fold.
+template<class Fold>
+bool FoldedLess(std::string_view lhs, std::string_view rhs, Fold fold) {
+  return std::lexicographical_compare(lhs.begin(), lhs.end(),
+				      rhs.begin(), rhs.end(),
+	   [fold](char x, char y) {
+	     return static_cast<unsigned char>(fold(x))
+		  < static_cast<unsigned char>(fold(y));
+	   });
+} // FoldedLess
+
+// key(i), for i in [0, n), must be sorted by FoldedLess(..., fold).
+// Returns the positions of at most max keys that start with prefix, after
+// fold: shortest first, then in table order.
+template<class Key, class Fold>
+std::vector<gsl::index> Complete(gsl::index n, Key key, Fold fold,
+				 std::string_view prefix, std::size_t max)
+{
+  namespace rng = std::ranges;
+  if (max == 0)
+    return {};
+  auto starts = [fold, prefix](std::string_view s) {
+    return s.size() >= prefix.size()
+	&& std::equal(prefix.begin(), prefix.end(), s.begin(),
+		      [fold](char x, char y) { return fold(x) == fold(y); });
+  };
+  const auto idx = std::views::iota(gsl::index{0}, n);
+  const auto first = rng::partition_point(idx, [&](gsl::index i) {
+    return FoldedLess(key(i), prefix, fold);
+  });
+  const auto last = rng::partition_point(first, idx.end(),
+    [&](gsl::index i) { return starts(key(i)); });
+
+  using Rank = std::pair<std::size_t, gsl::index>;  // length, position
+  std::vector<Rank> best;
+  for (auto i = first; i != last; ++i) {
+    const auto rank = Rank{key(*i).size(), *i};
+    if (best.size() < max) {
+      best.push_back(rank);
+      rng::push_heap(best);
+    }
+    else if (rank < best.front()) {
+      rng::pop_heap(best);
+      best.back() = rank;
+      rng::push_heap(best);
+    }
+  }
+  rng::sort_heap(best);
+  std::vector<gsl::index> found;
+  found.reserve(best.size());
+  for (const auto& rank: best)
+    found.push_back(rank.second);
+  return found;
+} // Complete
+
+#endif
@@ -0,0 +1,95 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "FileWatch.h"
+
+#include <filesystem>
+#include <system_error>
+#include <cstdint>
+#include <cerrno>
+
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::uint32_t Events
+  = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE;
+
+[[noreturn]] void ThrowErrno(const std::string& what)
+{ throw std::system_error{errno, std::generic_category(), what}; }
+
+std::string DirOf(const std::string& fname) {
+  auto dir = fs::path{fname}.parent_path();
+  return dir.empty() ? std::string{"."} : dir.string();
+} // DirOf
+
+} // local
+
+FileWatch::FileWatch() : fd{::inotify_init1(IN_CLOEXEC | IN_NONBLOCK)} {
+  if (fd < 0)
+    ThrowErrno("inotify");
+} // ctor
+
+FileWatch::~FileWatch() {
+  if (fd >= 0)
+    ::close(fd);
+} // dtor
+
+void FileWatch::watch(const std::vector<std::string>& fnames) {
+  files.clear();
+  std::set<std::string> want;
+  for (const auto& fname: fnames) {
+    auto dir = DirOf(fname);
+    files.insert(dir + '/' + fs::path{fname}.filename().string());
+    want.insert(std::move(dir));
+  }
+  // Directories already watched keep their watch (inotify returns the
+  // same one), so changes queued since they were added are not lost.
+  std::map<int, std::string> keep;
+  for (const auto& dir: want) {
+    int wd = ::inotify_add_watch(fd, dir.c_str(), Events);
+    if (wd < 0 && errno != ENOENT)
+      ThrowErrno(dir + ": cannot watch");
+    if (wd >= 0)
+      keep[wd] = dir;
+  }
+  for (const auto& [wd, dir]: dirs) {
+    if (!keep.contains(wd))
+      ::inotify_rm_watch(fd, wd);
+  }
+  dirs.swap(keep);
+} // watch
+
+void FileWatch::wait(std::chrono::milliseconds quiet) {
+  bool changed = false;
+  for (;;) {
+    pollfd pfd{fd, POLLIN, 0};
+    int n = ::poll(&pfd, 1, changed ? int(quiet.count()) : -1);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      ThrowErrno("inotify poll");
+    if (n == 0)
+      return;
+    alignas(inotify_event) char buf[4096];
+    auto size = ::read(fd, buf, sizeof(buf));
+    if (size < 0 && (errno == EINTR || errno == EAGAIN))
+      continue;
+    if (size < 0)
+      ThrowErrno("inotify read");
+    for (auto p = buf; p < buf + size; ) {
+      auto ev = reinterpret_cast<const inotify_event*>(p);
+      p += sizeof(inotify_event) + ev->len;
+      if (ev->mask & IN_Q_OVERFLOW) {
+	changed = true;
+	continue;
+      }
+      auto dir = dirs.find(ev->wd);
+      if (dir != dirs.end() && ev->len != 0
+	  && files.contains(dir->second + '/' + ev->name))
+	changed = true;
+    }
+  }
+} // wait
@@ -0,0 +1,34 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef FILEWATCH_H
+#define FILEWATCH_H
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <chrono>
+
+// Waits for any of a set of files to change.  The files' directories are
+// watched with inotify, rather than the files themselves, so that a file
+// that an editor replaces by renaming a new one over it is still seen.
+class FileWatch {
+  int fd = -1;
+  std::map<int, std::string> dirs;  // watch --> directory
+  std::set<std::string> files;      // directory/name
+public:
+  FileWatch();
+  FileWatch(const FileWatch&) = delete;
+  FileWatch& operator=(const FileWatch&) = delete;
+  ~FileWatch();
+
+  // Watches fnames instead of any earlier files.  Changes made since an
+  // earlier watch() of the same directory are still seen.
+  void watch(const std::vector<std::string>& fnames);
+
+  // Blocks until a watched file changes, and then until none has changed
+  // for quiet, so that a burst of saves is seen as one change.
+  void wait(std::chrono::milliseconds quiet);
+}; // FileWatch
+
+#endif
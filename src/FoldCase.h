@@ -0,0 +1,10 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef FOLD_CASE_H
+#define FOLD_CASE_H
+#pragma once
+
+// ASCII lower case, leaving every other byte (including UTF-8) alone.
+constexpr char FoldCase(char c)
+{ return (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c; }
+
+#endif
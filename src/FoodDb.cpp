@@ -0,0 +1,267 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "FoodDb.h"
+
+#include "Complete.h"
+
+#include <ranges>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cmath>
+#include <numeric>
+
+namespace rng = std::ranges;
+
+std::vector<std::string> FoodWords(std::string_view desc) {
+  auto alnum = [](char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z')
+	|| (c >= 'A' && c <= 'Z');
+  };
+  std::vector<std::string> words;
+  for (auto c = desc.begin(); c != desc.end(); ) {
+    if (!alnum(*c)) {
+      ++c;
+      continue;
+    }
+    auto& word = words.emplace_back();
+    for (; c != desc.end() && alnum(*c); ++c)
+      word.push_back((*c >= 'A' && *c <= 'Z') ? char(*c | 0x20) : *c);
+  }
+  return words;
+} // FoodWords
+
+FoodDb::FoodDb(const std::string& fname) : file{fname} {
+  auto invalid = [&fname](const std::string& why) {
+    return std::runtime_error{fname + ": " + why};
+  };
+  if (file.size() < sizeof(FoodHeader))
+    throw invalid("not a food database");
+  hdr = reinterpret_cast<const FoodHeader*>(file.data());
+  if (hdr->magic != FoodHeader::Magic)
+    throw invalid("not a food database");
+  if (hdr->version != FoodHeader::Version)
+    throw invalid("version " + std::to_string(hdr->version)
+		  + ", expected " + std::to_string(FoodHeader::Version)
+		  + "; rerun tabulate");
+  for (const auto& s: hdr->sections) {
+    if (s.offset % 8 != 0 || s.offset > file.size()
+	|| s.size > file.size() - s.offset)
+      throw invalid("corrupt section directory");
+  }
+  const auto& sect = hdr->sections;
+  if (sect[FoodHeader::foods].size != hdr->count * sizeof(FoodRecord)
+      || sect[FoodHeader::portions].size % sizeof(PortionRecord) != 0
+      || sect[FoodHeader::terms].size % sizeof(TermRecord) != 0
+      || sect[FoodHeader::postings].size % sizeof(PostingRecord) != 0
+      || sect[FoodHeader::by_desc].size != hdr->count * sizeof(std::uint32_t))
+    throw invalid("corrupt section sizes");
+  _foods = std::span{
+    reinterpret_cast<const FoodRecord*>(section(FoodHeader::foods).data()),
+    hdr->count
+  };
+  auto p = section(FoodHeader::portions);
+  _portions = std::span{reinterpret_cast<const PortionRecord*>(p.data()),
+			p.size() / sizeof(PortionRecord)};
+  strings = section(FoodHeader::strings);
+  if (strings.empty() || strings.back() != '\0')
+    throw invalid("corrupt string pool");
+  auto bad_str = [this](std::uint32_t s) { return (s >= strings.size()); };
+  for (const auto& food: _foods) {
+    if (bad_str(food.desc) || bad_str(food.atwater)
+	|| food.portion > _portions.size()
+	|| food.portions > _portions.size() - food.portion)
+      throw invalid("corrupt food " + std::to_string(food.fdc_id));
+  }
+  for (const auto& portion: _portions) {
+    if (bad_str(portion.desc) || bad_str(portion.comment))
+      throw invalid("corrupt portion");
+  }
+  auto t = section(FoodHeader::terms);
+  terms = std::span{reinterpret_cast<const TermRecord*>(t.data()),
+		    t.size() / sizeof(TermRecord)};
+  auto q = section(FoodHeader::postings);
+  postings = std::span{reinterpret_cast<const PostingRecord*>(q.data()),
+		       q.size() / sizeof(PostingRecord)};
+  for (const auto& term: terms) {
+    if (bad_str(term.str) || term.posting > postings.size()
+	|| term.postings > postings.size() - term.posting)
+      throw invalid("corrupt term");
+  }
+  for (const auto& posting: postings) {
+    if (posting.food >= _foods.size())
+      throw invalid("corrupt posting");
+  }
+  by_desc = std::span{reinterpret_cast<const std::uint32_t*>(
+			section(FoodHeader::by_desc).data()), hdr->count};
+  for (auto i: by_desc) {
+    if (i >= _foods.size())
+      throw invalid("corrupt description index");
+  }
+} // ctor
+
+const FoodRecord* FoodDb::find(std::uint32_t fdc_id) const {
+  auto food = rng::lower_bound(_foods, fdc_id, {}, &FoodRecord::fdc_id);
+  if (food == _foods.end() || food->fdc_id != fdc_id)
+    return nullptr;
+  return &*food;
+} // find
+
+std::vector<FoodDb::Match> FoodDb::rank(std::string_view query,
+					std::size_t k) const
+{
+  // Okapi BM25, with the usual k1 and b.
+  constexpr double K1 = 1.2;
+  constexpr double B  = 0.75;
+  const double n = _foods.size();
+  const double avg_words = n ? std::max(1.0, hdr->words / n) : 1.0;
+
+  auto words = FoodWords(query);
+  rng::sort(words);
+  words.erase(rng::unique(words).begin(), words.end());
+
+  // (food index, score) for every posting of every query word.
+  std::vector<std::pair<std::uint32_t, float>> hits;
+  for (const auto& word: words) {
+    auto term = rng::lower_bound(terms, std::string_view{word}, {},
+		  [this](const TermRecord& t) { return str(t.str); });
+    if (term == terms.end() || str(term->str) != word)
+      continue;
+    const double df = term->postings;
+    const double idf = std::log(1.0 + (n - df + 0.5) / (df + 0.5));
+    for (const auto& p: postings.subspan(term->posting, term->postings)) {
+      const double tf = p.count;
+      const double len = _foods[p.food].words;
+      const double norm = K1 * (1.0 - B + B * len / avg_words);
+      hits.emplace_back(p.food, float(idf * tf * (K1 + 1.0) / (tf + norm)));
+    }
+  }
+  rng::sort(hits);
+
+  std::vector<Match> matches;
+  for (auto hit = hits.begin(); hit != hits.end(); ) {
+    Match m{&_foods[hit->first], 0.0f};
+    for (const auto food = hit->first; hit != hits.end() && hit->first == food;
+	 ++hit)
+      m.score += hit->second;
+    matches.push_back(m);
+  }
+  // Best first, ties in fdc_id order.
+  auto better = [](const Match& lhs, const Match& rhs) {
+    return (lhs.score != rhs.score) ? lhs.score > rhs.score
+				    : lhs.food->fdc_id < rhs.food->fdc_id;
+  };
+  k = std::min(k, matches.size());
+  rng::partial_sort(matches, matches.begin() + k, better);
+  matches.resize(k);
+  return matches;
+} // rank
+
+std::vector<const FoodRecord*> FoodDb::complete(std::string_view prefix,
+						std::size_t max) const
+{
+  auto desc = [this](gsl::index i) { return str(_foods[by_desc[i]].desc); };
+  std::vector<const FoodRecord*> found;
+  for (auto i: Complete(size(), desc, FoldCase, prefix, max))
+    found.push_back(&_foods[by_desc[i]]);
+  return found;
+} // complete
+
+std::uint32_t FoodDbWriter::intern(std::string_view str) {
+  if (str.empty())
+    return 0;
+  if (auto iter = known.find(str); iter != known.end())
+    return iter->second;
+  const auto offset = gsl::narrow<std::uint32_t>(strings.size());
+  strings.append(str);
+  strings.push_back('\0');
+  known.emplace(str, offset);
+  return offset;
+} // intern
+
+void FoodDbWriter::add(FoodRecord food, std::string_view atwater,
+		       std::string_view desc)
+{
+  if (!foods.empty() && !(foods.back().fdc_id < food.fdc_id))
+    throw std::logic_error{"FoodDbWriter: fdc_ids not sorted"};
+  food.atwater = intern(atwater);
+  food.desc = intern(desc);
+  food.portion = gsl::narrow<std::uint32_t>(portions.size());
+  food.portions = 0;
+  auto desc_words = FoodWords(desc);
+  food.words = gsl::narrow<std::uint32_t>(desc_words.size());
+  words += food.words;
+  rng::sort(desc_words);
+  const auto index_of = gsl::narrow<std::uint32_t>(foods.size());
+  for (auto w = desc_words.begin(); w != desc_words.end(); ) {
+    auto next = std::find_if(w, desc_words.end(),
+			     [w](const auto& s) { return s != *w; });
+    index[*w].push_back(
+	PostingRecord{index_of, gsl::narrow<std::uint32_t>(next - w)});
+    w = next;
+  }
+  foods.push_back(food);
+} // add
+
+void FoodDbWriter::add_portion(float g, float ml, std::string_view desc,
+			       std::string_view comment)
+{
+  if (foods.empty())
+    throw std::logic_error{"FoodDbWriter: portion without a food"};
+  portions.push_back(PortionRecord{g, ml, intern(desc), intern(comment)});
+  ++foods.back().portions;
+} // add_portion
+
+void FoodDbWriter::write(const std::string& fname) const {
+  // The terms' strings go in the pool too, after those of the foods.
+  auto pool = strings;
+  std::vector<TermRecord> terms;
+  std::vector<PostingRecord> postings;
+  for (const auto& [word, list]: index) {
+    TermRecord term;
+    if (auto iter = known.find(word); iter != known.end()) {
+      term.str = iter->second;
+    }
+    else {
+      term.str = gsl::narrow<std::uint32_t>(pool.size());
+      pool.append(word);
+      pool.push_back('\0');
+    }
+    term.posting  = gsl::narrow<std::uint32_t>(postings.size());
+    term.postings = gsl::narrow<std::uint32_t>(list.size());
+    terms.push_back(term);
+    postings.insert(postings.end(), list.begin(), list.end());
+  }
+
+  std::vector<std::uint32_t> by_desc(foods.size());
+  std::iota(by_desc.begin(), by_desc.end(), std::uint32_t{0});
+  rng::stable_sort(by_desc, [this](std::uint32_t lhs, std::uint32_t rhs) {
+    auto desc = [this](std::uint32_t i) {
+      return std::string_view{strings.data() + foods[i].desc};
+    };
+    return FoldedLess(desc(lhs), desc(rhs), FoldCase);
+  });
+
+  FoodHeader hdr;
+  hdr.count = gsl::narrow<std::uint32_t>(foods.size());
+  hdr.words = words;
+  std::string buf(sizeof(hdr), '\0');
+  auto append = [&buf, &hdr](FoodHeader::Section s,
+			     const void* data, std::size_t size)
+  {
+    buf.resize((buf.size() + 7) & ~std::size_t{7}, '\0');
+    hdr.sections[s] = { buf.size(), size };
+    buf.append(static_cast<const char*>(data), size);
+  };
+  append(FoodHeader::foods, foods.data(), foods.size() * sizeof(foods[0]));
+  append(FoodHeader::portions, portions.data(),
+	 portions.size() * sizeof(portions[0]));
+  append(FoodHeader::strings, pool.data(), pool.size());
+  append(FoodHeader::terms, terms.data(), terms.size() * sizeof(terms[0]));
+  append(FoodHeader::postings, postings.data(),
+	 postings.size() * sizeof(postings[0]));
+  append(FoodHeader::by_desc, by_desc.data(),
+	 by_desc.size() * sizeof(by_desc[0]));
+  std::memcpy(buf.data(), &hdr, sizeof(hdr));
+
+  ReplaceFile(fname, buf);
+} // write
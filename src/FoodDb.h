@@ -0,0 +1,149 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef FOOD_DB_H
+#define FOOD_DB_H
+#pragma once
+
+#include "MappedFile.h"
+
+#include <gsl/gsl>
+
+#include <array>
+#include <map>
+#include <string>
+#include <string_view>
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+// usda_foods.bin layout (native byte order, version 3), written by
+// tabulate from usda_foods.tsv and usda_portions.tsv:
+//
+//   FoodHeader          magic, version, counts, section directory
+//   foods     FoodRecord[count]      sorted by fdc_id
+//   portions  PortionRecord[]        each food's together, in food order
+//   strings   char[]                 NUL-terminated, "" at offset 0
+//   terms     TermRecord[]           the words of the descriptions, sorted
+//   postings  PostingRecord[]        each term's together, in food order
+//   by_desc   uint32[count]          food indexes, by description ignoring
+//                                    case, for completion
+//
+// Every section is 8-byte aligned so it can be used in place from a
+// read-only mapping of the file.
+
+struct FoodRecord {
+  std::uint32_t fdc_id  = 0;
+  std::uint32_t desc    = 0;  // string offset
+  std::uint32_t atwater = 0;  // string offset, of "prot,fat,carb"
+  std::uint32_t portion = 0;  // first
+  std::uint32_t portions = 0;
+  std::uint32_t words   = 0;  // in desc
+  float kcal    = 0.0f;
+  float protein = 0.0f;
+  float fat     = 0.0f;
+  float carb    = 0.0f;
+  float fiber   = 0.0f;
+  float alcohol = 0.0f;
+}; // FoodRecord
+
+struct PortionRecord {
+  float g  = 0.0f;
+  float ml = 0.0f;
+  std::uint32_t desc    = 0;  // string offset
+  std::uint32_t comment = 0;  // string offset
+}; // PortionRecord
+
+struct TermRecord {
+  std::uint32_t str = 0;      // string offset
+  std::uint32_t posting = 0;  // first
+  std::uint32_t postings = 0;
+}; // TermRecord
+
+struct PostingRecord {
+  std::uint32_t food  = 0;  // index
+  std::uint32_t count = 0;  // of the term in its desc
+}; // PostingRecord
+
+struct FoodHeader {
+  static constexpr std::array<char, 8> Magic
+    = { 'U', 'S', 'D', 'A', 'B', 'I', 'N', '\n' };
+  static constexpr std::uint32_t Version = 3;
+  static constexpr int MaxSections = 8;
+  enum Section { foods, portions, strings, terms, postings, by_desc, end };
+  struct Extent {
+    std::uint64_t offset = 0;
+    std::uint64_t size   = 0;
+  }; // Extent
+  std::array<char, 8> magic = Magic;
+  std::uint32_t version = Version;
+  std::uint32_t count   = 0;
+  std::uint64_t words   = 0;  // in all descs
+  std::array<Extent, MaxSections> sections{};
+}; // FoodHeader
+
+static_assert(std::is_trivially_copyable_v<FoodRecord>);
+static_assert(std::is_trivially_copyable_v<PortionRecord>);
+static_assert(std::is_trivially_copyable_v<TermRecord>);
+static_assert(std::is_trivially_copyable_v<PostingRecord>);
+static_assert(FoodHeader::end <= FoodHeader::MaxSections);
+
+// The words of a description, or of a query for one: its runs of letters
+// and digits, in lower case.
+std::vector<std::string> FoodWords(std::string_view desc);
+
+class FoodDb {
+  MappedFile file;
+  const FoodHeader* hdr = nullptr;
+  std::span<const FoodRecord> _foods;
+  std::span<const PortionRecord> _portions;
+  std::string_view strings;
+  std::span<const TermRecord> terms;
+  std::span<const PostingRecord> postings;
+  std::span<const std::uint32_t> by_desc;
+  std::string_view section(FoodHeader::Section s) const {
+    const auto& x = hdr->sections[s];
+    return std::string_view{file.data() + x.offset, x.size};
+  }
+public:
+  explicit FoodDb(const std::string& fname);
+  gsl::index size() const { return _foods.size(); }
+  // The food with fdc_id, or null.
+  const FoodRecord* find(std::uint32_t fdc_id) const;
+  std::span<const PortionRecord> portions(const FoodRecord& food) const
+    { return _portions.subspan(food.portion, food.portions); }
+  std::string_view str(std::uint32_t offset) const
+    { return std::string_view{strings.data() + offset}; }
+
+  struct Match {
+    const FoodRecord* food = nullptr;
+    float score = 0.0f;
+  }; // Match
+  // The k foods whose descriptions best match the words of query, best
+  // first, scored by BM25.
+  std::vector<Match> rank(std::string_view query, std::size_t k) const;
+
+  // At most max foods whose descriptions start with prefix, ignoring case,
+  // shortest first.
+  std::vector<const FoodRecord*> complete(std::string_view prefix,
+					  std::size_t max) const;
+}; // FoodDb
+
+// Collects foods, in fdc_id order, each followed by its portions, and
+// writes a usda_foods.bin file.
+class FoodDbWriter {
+  std::vector<FoodRecord> foods;
+  std::vector<PortionRecord> portions;
+  std::string strings{'\0'};
+  std::map<std::string, std::uint32_t, std::less<>> known;
+  std::map<std::string, std::vector<PostingRecord>> index;
+  std::uint64_t words = 0;
+  std::uint32_t intern(std::string_view str);
+public:
+  void add(FoodRecord food, std::string_view atwater, std::string_view desc);
+  void add_portion(float g, float ml,
+		   std::string_view desc, std::string_view comment);
+  gsl::index size() const { return foods.size(); }
+  void write(const std::string& fname) const;
+}; // FoodDbWriter
+
+#endif
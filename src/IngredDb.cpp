@@ -0,0 +1,305 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "IngredDb.h"
+
+#include "Normalize.h"
+#include "Complete.h"
+
+#include <ranges>
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+
+namespace rng = std::ranges;
+
+namespace {
+
+constexpr int AliasPluralShift = 30;
+constexpr std::uint32_t AliasIndexMask = (1u << AliasPluralShift) - 1;
+constexpr std::uint32_t SynonymCollides = 1u << 31;
+
+} // local
+
+std::string IngredDb::DefaultPath() {
+  gsl::czstring dir = std::getenv("INGRED_PATH");
+  if (!dir)
+    throw std::runtime_error{"INGRED_PATH not set"};
+  return dir + std::string{"/ingred.dat"};
+} // DefaultPath
+
+IngredDb::IngredDb(const std::string& fname) : file{fname} {
+  auto invalid = [&fname](const std::string& why) {
+    return std::runtime_error{fname + ": " + why};
+  };
+  if (file.size() < sizeof(IngredHeader))
+    throw invalid("not an ingredient database");
+  hdr = reinterpret_cast<const IngredHeader*>(file.data());
+  if (hdr->magic != IngredHeader::Magic)
+    throw invalid("not an ingredient database");
+  if (hdr->version != IngredHeader::Version)
+    throw invalid("version " + std::to_string(hdr->version)
+		  + ", expected " + std::to_string(IngredHeader::Version)
+		  + "; rerun digest");
+  for (const auto& s: hdr->sections) {
+    if (s.offset % 8 != 0 || s.offset > file.size()
+	|| s.size > file.size() - s.offset)
+      throw invalid("corrupt section directory");
+  }
+  const auto& sect = hdr->sections;
+  const auto count = std::uint64_t{hdr->count};
+  if (sect[IngredHeader::offsets].size != (count+1) * sizeof(std::uint32_t)
+      || sect[IngredHeader::records].size != count * sizeof(Nutrition))
+    throw invalid("corrupt section sizes");
+  offsets = reinterpret_cast<const std::uint32_t*>(
+			section(IngredHeader::offsets).data());
+  records = reinterpret_cast<const Nutrition*>(
+			section(IngredHeader::records).data());
+  strings = section(IngredHeader::strings).data();
+  if (offsets[count] != sect[IngredHeader::strings].size)
+    throw invalid("corrupt string pool");
+  // Each name is followed by a NUL, so the offsets strictly increase.
+  for (std::uint64_t i = 0; i != count; ++i) {
+    if (offsets[i] >= offsets[i+1])
+      throw invalid("corrupt string pool");
+  }
+  try {
+    hash = PerfectHash{section(IngredHeader::hash)};
+    alias_hash = PerfectHash{section(IngredHeader::alias_hash)};
+    trigrams = TrigramIndex{section(IngredHeader::trigrams)};
+    syn_hash = PerfectHash{section(IngredHeader::syn_hash)};
+  }
+  catch (const std::exception& x) {
+    throw invalid(x.what());
+  }
+  {
+    auto a = section(IngredHeader::aliases);
+    aliases = std::span{reinterpret_cast<const std::uint32_t*>(a.data()),
+			a.size() / sizeof(std::uint32_t)};
+    if (alias_hash.empty() != aliases.empty())
+      throw invalid("corrupt alias table");
+    for (auto alias: aliases) {
+      if ((alias & AliasIndexMask) >= count)
+	throw invalid("corrupt alias table");
+    }
+  }
+  {
+    auto s = section(IngredHeader::synonyms);
+    synonyms = std::span{reinterpret_cast<const std::uint32_t*>(s.data()),
+			 s.size() / sizeof(std::uint32_t)};
+    if (syn_hash.empty() != synonyms.empty()
+	|| (!synonyms.empty() && aliases.empty()))
+      throw invalid("corrupt synonym table");
+    for (auto syn: synonyms) {
+      if ((syn & ~SynonymCollides) >= count)
+	throw invalid("corrupt synonym table");
+    }
+  }
+  if (!trigrams.empty() && trigrams.keys() != size())
+    throw invalid("corrupt trigram index");
+} // ctor
+
+auto IngredDb::find(std::string_view name) const
+  -> std::optional<gsl::index>
+{
+  if (!hash.empty()) {
+    auto i = hash(name);
+    if (i < 0 || i >= size() || this->name(i) != name)
+      return std::nullopt;
+    return i;
+  }
+  auto idx = rng::views::iota(gsl::index{0}, size());
+  auto i = rng::lower_bound(idx, name, {},
+			    [this](gsl::index j) { return this->name(j); });
+  if (i == idx.end() || this->name(*i) != name)
+    return std::nullopt;
+  return *i;
+} // find
+
+auto IngredDb::lookup(std::string_view name) const
+  -> std::optional<gsl::index>
+{
+  if (name.empty())
+    return std::nullopt;
+  if (aliases.empty()) {
+    for (int p = 0; p != int(Plural::end); ++p) {
+      if (auto stem = Singular(name, Plural(p))) {
+	if (auto i = find(*stem))
+	  return i;
+      }
+    }
+    return std::nullopt;
+  }
+  auto a = alias_hash(name);
+  if (a < 0 || a >= gsl::index(aliases.size()))
+    return std::nullopt;
+  const auto i = gsl::index{aliases[a] & AliasIndexMask};
+  const auto p = Plural(aliases[a] >> AliasPluralShift);
+  if (i >= size() || !IsPlural(name, this->name(i), p))
+    return std::nullopt;
+  return i;
+} // lookup
+
+auto IngredDb::lookup(std::string_view name, std::string_view synonym) const
+  -> std::optional<gsl::index>
+{
+  auto twice = [&]() -> std::optional<gsl::index> {
+    if (auto i = lookup(name))
+      return i;
+    if (synonym == name)
+      return std::nullopt;
+    return lookup(synonym);
+  };
+  if (name.empty())
+    return std::nullopt;
+  if (synonyms.empty())
+    return twice();
+  auto s = syn_hash(synonym);
+  if (s < 0 || s >= gsl::index(synonyms.size()))
+    return std::nullopt;
+  if (synonyms[s] & SynonymCollides)
+    return twice();
+  // Every form sharing this synonym matches entry i, so name is found if
+  // either it or its synonym is one of i's forms.
+  const auto i = gsl::index{synonyms[s]};
+  for (int p = 0; p != int(Plural::end); ++p) {
+    if (IsPlural(name, this->name(i), Plural(p))
+	|| IsPlural(synonym, this->name(i), Plural(p)))
+      return i;
+  }
+  return std::nullopt;
+} // lookup
+
+std::vector<gsl::index> IngredDb::suggest(std::string_view name,
+					  std::size_t max) const
+{
+  // One edit per four characters, at least one and at most three.
+  const int edits = std::clamp(int(name.size()) / 4, 1, 3);
+  const int min_shared
+    = int(TrigramIndex::Trigrams(name).size()) - 3 * edits;
+  struct Near {
+    int dist = 0;
+    std::size_t skew = 0;  // length difference
+    gsl::index i = 0;
+    auto operator<=>(const Near&) const = default;
+  }; // Near
+  std::vector<Near> near;
+  for (auto i: trigrams.candidates(name, std::max(1, min_shared))) {
+    const auto other = this->name(i);
+    const auto dist = BoundedEditDistance(name, other, edits);
+    if (dist <= edits) {
+      const auto skew = std::max(name.size(), other.size())
+		      - std::min(name.size(), other.size());
+      near.push_back(Near{dist, skew, i});
+    }
+  }
+  max = std::min(max, near.size());
+  rng::partial_sort(near, near.begin() + max);
+  std::vector<gsl::index> found;
+  for (const auto& n: near | std::views::take(max))
+    found.push_back(n.i);
+  return found;
+} // suggest
+
+std::vector<gsl::index> IngredDb::complete(std::string_view prefix,
+					   std::size_t max) const
+{
+  // The names are stored sorted, so they are their own prefix index.
+  return Complete(size(), [this](gsl::index i) { return name(i); },
+		  SameCase, prefix, max);
+} // complete
+
+void IngredDbWriter::add(std::string_view name, const Nutrition& nutr) {
+  if (!strings.empty()) {
+    auto last = std::string_view{strings}.substr(offsets.back());
+    last.remove_suffix(1);
+    if (!(last < name))
+      throw std::logic_error{"IngredDbWriter: names not sorted"};
+  }
+  offsets.push_back(gsl::narrow_cast<std::uint32_t>(strings.size()));
+  strings.append(name);
+  strings.push_back('\0');
+  records.push_back(nutr);
+} // add
+
+void IngredDbWriter::write(const std::string& fname) const {
+  auto offs = offsets;
+  offs.push_back(gsl::narrow_cast<std::uint32_t>(strings.size()));
+
+  IngredHeader hdr;
+  hdr.count = gsl::narrow_cast<std::uint32_t>(records.size());
+  std::string buf(sizeof(hdr), '\0');
+  auto append = [&buf, &hdr](IngredHeader::Section s,
+			     const void* data, std::size_t size)
+  {
+    buf.resize((buf.size() + 7) & ~std::size_t{7}, '\0');
+    hdr.sections[s] = { buf.size(), size };
+    buf.append(static_cast<const char*>(data), size);
+  };
+  append(IngredHeader::offsets, offs.data(),
+	 offs.size() * sizeof(offs[0]));
+  append(IngredHeader::records, records.data(),
+	 records.size() * sizeof(records[0]));
+  append(IngredHeader::strings, strings.data(), strings.size());
+  {
+    std::vector<std::string_view> names;
+    names.reserve(records.size());
+    for (gsl::index i = 0; i != size(); ++i)
+      names.emplace_back(strings.data() + offs[i], offs[i+1] - offs[i] - 1);
+    auto table = PerfectHash::Build(names);
+    append(IngredHeader::hash, table.data(), table.size());
+
+    // Every plural nut accepts, mapped to the entry its plural stripping
+    // would find first.
+    if (names.size() > AliasIndexMask)
+      throw std::runtime_error{fname + ": too many ingredients"};
+    std::map<std::string, std::uint32_t> forms;
+    for (int p = 0; p != int(Plural::end); ++p) {
+      for (std::uint32_t i = 0; i != names.size(); ++i) {
+	if (auto form = MakePlural(names[i], Plural(p)))
+	  forms.try_emplace(std::move(*form),
+			    (std::uint32_t(p) << AliasPluralShift) | i);
+      }
+    }
+    std::vector<std::string_view> keys;
+    std::vector<std::uint32_t> targets;
+    keys.reserve(forms.size());
+    targets.reserve(forms.size());
+    for (const auto& [form, target]: forms) {
+      keys.push_back(form);
+      targets.push_back(target);
+    }
+    table = PerfectHash::Build(keys);
+    append(IngredHeader::alias_hash, table.data(), table.size());
+    append(IngredHeader::aliases, targets.data(),
+	   targets.size() * sizeof(targets[0]));
+
+    // The same forms under nut's second chance, so one probe serves for
+    // both, unless forms of different entries rewrite alike.
+    std::map<std::string, std::uint32_t> syns;
+    for (const auto& [form, target]: forms) {
+      auto syn = form;
+      SubstLookupSynonyms(syn);
+      const auto i = target & AliasIndexMask;
+      auto [it, added] = syns.try_emplace(std::move(syn), i);
+      if (!added && (it->second & ~SynonymCollides) != i)
+	it->second |= SynonymCollides;
+    }
+    keys.clear();
+    targets.clear();
+    for (const auto& [syn, target]: syns) {
+      keys.push_back(syn);
+      targets.push_back(target);
+    }
+    table = PerfectHash::Build(keys);
+    append(IngredHeader::syn_hash, table.data(), table.size());
+    append(IngredHeader::synonyms, targets.data(),
+	   targets.size() * sizeof(targets[0]));
+
+    auto grams = TrigramIndex::Build(names);
+    append(IngredHeader::trigrams, grams.data(), grams.size());
+  }
+  std::memcpy(buf.data(), &hdr, sizeof(hdr));
+
+  ReplaceFile(fname, buf);
+} // write
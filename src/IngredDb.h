@@ -0,0 +1,116 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef INGRED_DB_H
+#define INGRED_DB_H
+#pragma once
+
+#include "Nutrition.h"
+#include "MappedFile.h"
+#include "PerfectHash.h"
+#include "TrigramIndex.h"
+
+#include <gsl/gsl>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+// ingred.dat layout (native byte order, version 2):
+//
+//   IngredHeader        magic, version, entry count, section directory
+//   offsets  uint32[count+1]   byte offset of each name in the string pool
+//   records  Nutrition[count]  one record per name, same order
+//   strings  char[]            NUL-terminated names, sorted
+//   hash     PerfectHash       name --> index (optional)
+//   alias_hash  PerfectHash    surface form --> alias (optional)
+//   aliases  uint32[]          Plural << 30 | index of the named entry
+//   trigrams TrigramIndex      of the names, for suggestions (optional)
+//   syn_hash PerfectHash       surface form, as SubstLookupSynonyms
+//                              rewrites it --> synonym (optional)
+//   synonyms uint32[]          index of the entry its forms match, with
+//                              bit 31 set if forms of two entries collide
+//
+// Every section is 8-byte aligned so it can be used in place from a
+// read-only mapping of the file.
+
+struct IngredHeader {
+  static constexpr std::array<char, 8> Magic
+    = { 'N', 'U', 'T', 'D', 'A', 'T', '\r', '\n' };
+  static constexpr std::uint32_t Version = 2;
+  static constexpr int MaxSections = 16;
+  enum Section { offsets, records, strings, hash, alias_hash, aliases,
+		 trigrams, syn_hash, synonyms, end };
+  struct Extent {
+    std::uint64_t offset = 0;
+    std::uint64_t size   = 0;
+  }; // Extent
+  std::array<char, 8> magic = Magic;
+  std::uint32_t version = Version;
+  std::uint32_t count   = 0;
+  std::array<Extent, MaxSections> sections{};
+}; // IngredHeader
+
+static_assert(std::is_trivially_copyable_v<Nutrition>);
+static_assert(sizeof(Nutrition) == 8 * sizeof(float));
+static_assert(IngredHeader::end <= IngredHeader::MaxSections);
+
+class IngredDb {
+  MappedFile file;
+  const IngredHeader* hdr = nullptr;
+  const std::uint32_t* offsets = nullptr;
+  const Nutrition* records = nullptr;
+  const char* strings = nullptr;
+  PerfectHash hash;
+  PerfectHash alias_hash;
+  std::span<const std::uint32_t> aliases;
+  TrigramIndex trigrams;
+  PerfectHash syn_hash;
+  std::span<const std::uint32_t> synonyms;
+  std::string_view section(IngredHeader::Section s) const {
+    const auto& x = hdr->sections[s];
+    return std::string_view{file.data() + x.offset, x.size};
+  }
+public:
+  static std::string DefaultPath();
+  explicit IngredDb(const std::string& fname);
+  IngredDb() : IngredDb{DefaultPath()} { }
+  gsl::index size() const { return hdr->count; }
+  std::string_view name(gsl::index i) const {
+    return std::string_view{strings + offsets[i],
+			    offsets[i+1] - offsets[i] - 1};
+  }
+  const Nutrition& nutr(gsl::index i) const { return records[i]; }
+  // Exact match.
+  std::optional<gsl::index> find(std::string_view name) const;
+  // Matches name or one of its plurals, the way nut always has.
+  std::optional<gsl::index> lookup(std::string_view name) const;
+  // lookup(name), or else lookup(synonym), where synonym is name as
+  // SubstLookupSynonyms rewrites it; one probe unless the synonyms of
+  // two entries collide.
+  std::optional<gsl::index> lookup(std::string_view name,
+				   std::string_view synonym) const;
+  // At most max names within a few edits of name, nearest first, for
+  // "did you mean"; none if ingred.dat predates its trigram index.
+  std::vector<gsl::index> suggest(std::string_view name,
+				  std::size_t max) const;
+  // At most max names that start with prefix, shortest first.
+  std::vector<gsl::index> complete(std::string_view prefix,
+				   std::size_t max) const;
+}; // IngredDb
+
+// Collects ingredients, in sorted order, and writes an ingred.dat file.
+class IngredDbWriter {
+  std::vector<std::uint32_t> offsets;
+  std::vector<Nutrition> records;
+  std::string strings;
+public:
+  void add(std::string_view name, const Nutrition& nutr);
+  gsl::index size() const { return records.size(); }
+  void write(const std::string& fname) const;
+}; // IngredDbWriter
+
+#endif
@@ -0,0 +1,565 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "Ingredients.h"
+
+#include "PerfectHash.h"
+#include "MappedFile.h"
+
+#include <ranges>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <atomic>
+#include <tuple>
+#include <stdexcept>
+#include <cstring>
+
+namespace rng = std::ranges;
+
+namespace {
+
+constexpr std::uint64_t Seed = 0x6e75742d63616368u;
+constexpr std::uint32_t CacheMagic   = 0x6e757463u;
+constexpr std::uint32_t CacheVersion = 2;
+
+std::string_view Bytes(const Nutrition& nutr)
+{ return { reinterpret_cast<const char*>(&nutr), sizeof(nutr) }; }
+
+bool Same(const Nutrition& lhs, const Nutrition& rhs)
+{ return (std::memcmp(&lhs, &rhs, sizeof(lhs)) == 0); }
+
+std::uint64_t HashOf(std::string_view str)
+{ return PerfectHash::Hash(str, Seed); }
+
+// The state hashes are sums over the entries, so they are kept up to date
+// as entries come and go.
+std::uint64_t HashOf(std::string_view key, std::string_view value)
+{ return PerfectHash::Hash(value, HashOf(key)); }
+
+} // local
+
+Ingredients::Ingredients(Reader reader_, const Ingredients& base_)
+  : reader{reader_}, base{&base_}, _defs{base_._defs},
+    nuts_hash{base_.nuts_hash}, defs_hash{base_.defs_hash},
+    once_files{base_.once_files}
+{ } // ctor
+
+const Nutrition* Ingredients::lookup(const std::string& name) const {
+  if (auto e = nuts.find(name))
+    return &e->nutr;
+  if (base) {
+    if (auto e = base->nuts.find(name))
+      return &e->nutr;
+  }
+  return nullptr;
+} // lookup
+
+void Ingredients::flush(bool record) {
+  auto text = std::move(_log).str();
+  _log.str({});
+  if (text.empty())
+    return;
+  report += text;
+  if (record && !frames.empty() && frames.back().record)
+    frames.back().record->ops.push_back(Op{Op::output, std::move(text)});
+} // flush
+
+void Ingredients::record(Op op) {
+  flush(true);
+  if (!frames.empty() && frames.back().record)
+    frames.back().record->ops.push_back(std::move(op));
+} // record
+
+void Ingredients::put(const std::string& name, const Nutrition& nutr,
+		      bool replace)
+{
+  if (base && !nuts.contains(name)) {
+    // An entry of base is copied, its hash already counted, to be replaced.
+    if (auto b = base->nuts.find(name)) {
+      if (!replace)
+	return;
+      nuts.try_emplace(name, b->nutr);
+    }
+  }
+  auto [e, added] = nuts.try_emplace(name, nutr);
+  if (added) {
+    if (replaying)
+      nuts_undo.emplace_back(name, std::nullopt);
+    index.add(e->name);
+  }
+  else {
+    if (!replace)
+      return;
+    if (replaying)
+      nuts_undo.emplace_back(name, e->nutr);
+    nuts_hash -= HashOf(e->name, Bytes(e->nutr));
+    e->nutr = nutr;
+  }
+  nuts_hash += HashOf(e->name, Bytes(e->nutr));
+} // put
+
+void Ingredients::set(const std::string& var,
+		      std::optional<std::string> val)
+{
+  auto iter = _defs.find(var);
+  if (replaying) {
+    if (iter == _defs.end())
+      defs_undo.emplace_back(var, std::nullopt);
+    else
+      defs_undo.emplace_back(var, iter->second);
+  }
+  if (iter != _defs.end()) {
+    defs_hash -= HashOf(iter->first, iter->second);
+    if (!val) {
+      _defs.erase(iter);
+      return;
+    }
+    iter->second = std::move(*val);
+  }
+  else {
+    if (!val)
+      return;
+    iter = _defs.emplace(var, std::move(*val)).first;
+  }
+  defs_hash += HashOf(iter->first, iter->second);
+} // set
+
+bool Ingredients::apply(const Op& op) {
+  switch (op.kind) {
+    case Op::output:
+      report += op.name;
+      return true;
+    case Op::include:
+      read(op.name);
+      return true;
+    case Op::define:
+      set(op.name, op.text);
+      return true;
+    case Op::undef:
+      set(op.name, std::nullopt);
+      return true;
+    case Op::defs:
+      return (defs_hash == op.hash);
+    case Op::find: {
+      auto e = nuts.find(op.name);
+      if (!e)
+	return (op.hash == 0);
+      return (op.hash == 1 && Same(e->nutr, op.nutr));
+    }
+    case Op::insert: {
+      const bool present = nuts.contains(op.name);
+      if (present != (op.hash != 0))
+	return false;
+      put(op.name, op.nutr, false);
+      return true;
+    }
+    case Op::assign:
+      put(op.name, op.nutr, true);
+      return true;
+    case Op::fingerprint:
+      return (nuts_hash == op.hash);
+    case Op::emplace:
+      put(op.name, op.nutr, false);
+      return true;
+    case Op::once:
+      if (rng::find(once_files, op.name) == once_files.end())
+	once_files.push_back(op.name);
+      return true;
+    default:
+      return false;
+  }
+} // apply
+
+void Ingredients::rollback(const Frame& frame) {
+  while (nuts_undo.size() > frame.nuts_mark) {
+    auto& [name, old] = nuts_undo.back();
+    auto e = nuts.find(name);
+    nuts_hash -= HashOf(e->name, Bytes(e->nutr));
+    if (old) {
+      e->nutr = *old;
+      nuts_hash += HashOf(e->name, Bytes(e->nutr));
+    }
+    else {
+      // Additions are undone last first.
+      index.pop_back();
+      nuts.pop_back();
+    }
+    nuts_undo.pop_back();
+  }
+  while (defs_undo.size() > frame.defs_mark) {
+    auto& [var, old] = defs_undo.back();
+    auto iter = _defs.find(var);
+    if (iter != _defs.end()) {
+      defs_hash -= HashOf(iter->first, iter->second);
+      if (old)
+	iter->second = *old;
+      else
+	_defs.erase(iter);
+    }
+    else if (old) {
+      iter = _defs.emplace(var, *old).first;
+    }
+    if (old)
+      defs_hash += HashOf(iter->first, iter->second);
+    defs_undo.pop_back();
+  }
+  _log.str({});
+  report.resize(frame.report_mark);
+  once_files.resize(frame.once_mark);
+} // rollback
+
+Ingredients::Frame Ingredients::mark(const std::string& fname,
+				     std::shared_ptr<Record> rec) const
+{
+  return Frame{fname, std::move(rec), nuts_undo.size(), defs_undo.size(),
+	       report.size(), once_files.size()};
+} // mark
+
+void Ingredients::keep(const std::string& fname,
+		       std::shared_ptr<const Record> rec)
+{
+  auto& recs = used[fname];
+  std::erase_if(recs, [&rec](const auto& r) { return r->defs == rec->defs; });
+  recs.push_back(std::move(rec));
+} // keep
+
+void Ingredients::read(const std::string& fname) {
+  if (!runs.empty() && runs.back().fnames.back() == fname) {
+    auto& run = runs.back();
+    if (run.parsed == 0 || run.defs != defs_hash)
+      parse_ahead(run);
+    run.fnames.pop_back();
+    --run.parsed;
+    if (run.fnames.empty())
+      runs.pop_back();
+  }
+  record(Op{Op::include, fname});
+  if (rng::find(_files, fname) == _files.end())
+    _files.push_back(fname);
+  if (rng::find(once_files, fname) == once_files.end()) {
+    // Already read in this run with these #defines: replay it unread.
+    // Parsing ahead never replays, since base cannot be rolled back.
+    std::shared_ptr<const Record> rec;
+    if (auto iter = used.find(fname); !base && iter != used.end()) {
+      auto r = rng::find_if(iter->second, [this](const auto& r)
+			    { return r->defs == defs_hash; });
+      if (r != iter->second.end())
+	rec = *r;
+    }
+    if (!rec || !replay(fname, std::move(rec)))
+      reader(fname, *this);
+  }
+  flush(false);  // e.g. could not read
+  record(Op{Op::defs, {}, {}, {}, defs_hash});
+} // read
+
+void Ingredients::prefetch(const std::vector<std::string>& fnames) {
+  if (!base && std::thread::hardware_concurrency() > 1 && fnames.size() > 1)
+    runs.push_back(Run{{fnames.rbegin(), fnames.rend()}});
+} // prefetch
+
+// Parses the next of run, as many as there are threads, each with the
+// ingredients and #defines as they are now.
+void Ingredients::parse_ahead(Run& run) {
+  const auto count = std::min<std::size_t>(
+			std::thread::hardware_concurrency(), run.fnames.size());
+  run.parsed = count;
+  run.defs = defs_hash;
+  if (count < 2)
+    return;  // nothing to gain
+  std::vector<std::unique_ptr<Ingredients>> dbs(count);
+  std::atomic<std::size_t> next = 0;
+  auto worker = [&]() {
+    for (std::size_t i; (i = next++) < count; ) {
+      auto db = std::unique_ptr<Ingredients>{new Ingredients{reader, *this}};
+      try {
+	db->read(run.fnames.rbegin()[i]);
+      }
+      catch (const std::exception&) {
+	db->spoiled = true;
+      }
+      dbs[i] = std::move(db);
+    }
+  };
+  {
+    std::vector<std::jthread> pool;
+    for (std::size_t t = 1; t < count; ++t)
+      pool.emplace_back(worker);
+    worker();
+  }
+  for (auto& db: dbs) {
+    if (db->spoiled)
+      continue;
+    for (auto& [fname, recs]: db->used)
+      rng::move(recs, std::back_inserter(ahead[fname]));
+  }
+} // parse_ahead
+
+void Ingredients::restart() {
+  for (auto& [fname, recs]: used)
+    cached[fname] = std::move(recs);
+  used.clear();
+  ahead.clear();
+  runs.clear();
+  nuts = NutritionTable{};
+  index = NameIndex{};
+  _defs.clear();
+  nuts_hash = 0;
+  defs_hash = 0;
+  _log.str({});
+  report.clear();
+  frames.clear();
+  replaying = 0;
+  nuts_undo.clear();
+  defs_undo.clear();
+  once_files.clear();
+  _files.clear();
+} // restart
+
+bool Ingredients::changed() const {
+  for (const auto& fname: _files) {
+    const auto iter = used.find(fname);
+    auto input = std::ifstream{fname, std::ios::binary};
+    if (!input) {
+      if (iter != used.end())
+	return true;
+      continue;
+    }
+    const auto hash = HashOf(std::string{std::istreambuf_iterator<char>{input},
+					 std::istreambuf_iterator<char>{}});
+    if (iter == used.end()
+	|| rng::none_of(iter->second, [hash](const auto& r)
+			{ return r->hash == hash; }))
+      return true;
+  }
+  return false;
+} // changed
+
+bool Ingredients::replay(const std::string& fname, std::string_view text) {
+  const auto hash = HashOf(text);
+  auto match = [&](const Records& records) {
+    std::shared_ptr<const Record> rec;
+    if (auto iter = records.find(fname); iter != records.end()) {
+      auto r = rng::find_if(iter->second, [&](const auto& r)
+			    { return r->hash == hash && r->defs == defs_hash; });
+      if (r != iter->second.end())
+	rec = *r;
+    }
+    return rec;
+  };
+  if (base) {
+    // Parsing ahead: a file that base can replay is left to it.
+    return frames.empty()
+	&& (match(base->used) || match(base->ahead) || match(base->cached));
+  }
+  for (const auto* records: {&used, &ahead, &cached}) {
+    if (auto rec = match(*records); rec && replay(fname, std::move(rec)))
+      return true;
+  }
+  return false;
+} // replay
+
+bool Ingredients::replay(const std::string& fname,
+			 std::shared_ptr<const Record> rec)
+{
+  flush(false);
+  frames.push_back(mark(fname, nullptr));
+  ++replaying;
+  const bool ok = rng::all_of(rec->ops, [this](const Op& op)
+			      { return apply(op); });
+  --replaying;
+  auto frame = std::move(frames.back());
+  frames.pop_back();
+  if (!ok)
+    rollback(frame);
+  if (replaying == 0) {
+    nuts_undo.clear();
+    defs_undo.clear();
+  }
+  if (ok)
+    keep(fname, std::move(rec));
+  return ok;
+} // replay
+
+void Ingredients::begin(const std::string& fname, std::string_view text) {
+  flush(false);
+  auto rec = std::make_shared<Record>();
+  rec->hash = HashOf(text);
+  rec->defs = defs_hash;
+  frames.push_back(mark(fname, std::move(rec)));
+} // begin
+
+void Ingredients::end() {
+  flush(true);
+  auto frame = std::move(frames.back());
+  frames.pop_back();
+  keep(frame.fname, std::move(frame.record));
+} // end
+
+const Nutrition* Ingredients::find(const std::string& name) {
+  auto nutr = lookup(name);
+  if (!nutr) {
+    record(Op{Op::find, name});
+    return nullptr;
+  }
+  record(Op{Op::find, name, {}, *nutr, 1});
+  return nutr;
+} // find
+
+bool Ingredients::insert(const std::string& name, const Nutrition& nutr) {
+  const bool present = (lookup(name) != nullptr);
+  record(Op{Op::insert, name, {}, nutr, present});
+  if (!present)
+    put(name, nutr, false);
+  return !present;
+} // insert
+
+void Ingredients::assign(const std::string& name, const Nutrition& nutr) {
+  record(Op{Op::assign, name, {}, nutr});
+  put(name, nutr, true);
+} // assign
+
+void Ingredients::search(const std::regex& s, std::string_view literal,
+			 const std::string& r)
+{
+  if (base) {
+    // Parsing ahead, not all of the ingredients are here to be searched.
+    spoiled = true;
+    return;
+  }
+  record(Op{Op::fingerprint, {}, {}, {}, nuts_hash});
+  struct Add {
+    std::string name;
+    std::string_view from;
+    Nutrition nutr;
+  }; // Add
+  std::vector<Add> add;
+  auto try_replace = [&](const NutritionTable::Entry& e) {
+    if (std::regex_search(e.name.begin(), e.name.end(), s)) {
+      add.push_back(Add{std::regex_replace(std::string{e.name}, s, r),
+			e.name, e.nutr});
+    }
+  };
+  if (literal.size() < NameIndex::Gram) {
+    for (const auto& e: nuts)
+      try_replace(e);
+  }
+  else {
+    // Only names holding every trigram of the literal can match.
+    for (auto name: index.candidates(literal))
+      try_replace(*nuts.find(name));
+  }
+  // Insert by name; of equal names, the one made from the first name in
+  // sorted order wins, as when the ingredients were a std::map.
+  rng::sort(add, [](const Add& lhs, const Add& rhs) {
+    return std::tie(lhs.name, lhs.from) < std::tie(rhs.name, rhs.from);
+  });
+  for (const auto& [name, from, nutr]: add) {
+    if (!nuts.contains(name)) {
+      record(Op{Op::emplace, name, {}, nutr});
+      put(name, nutr, false);
+    }
+  }
+} // search
+
+void Ingredients::define(const std::string& var, const std::string& val) {
+  record(Op{Op::define, var, val});
+  set(var, val);
+} // define
+
+void Ingredients::undef(const std::string& var) {
+  record(Op{Op::undef, var});
+  set(var, std::nullopt);
+} // undef
+
+void Ingredients::pragma_once() {
+  const auto& fname = frames.back().fname;
+  record(Op{Op::once, fname});
+  if (rng::find(once_files, fname) == once_files.end())
+    once_files.push_back(fname);
+} // pragma_once
+
+void Ingredients::load(const std::string& fname) {
+  cached.clear();
+  auto input = std::ifstream{fname, std::ios::binary};
+  if (!input)
+    return;
+  const auto buf = std::string{std::istreambuf_iterator<char>{input},
+			       std::istreambuf_iterator<char>{}};
+  std::size_t pos = 0;
+  auto get = [&buf, &pos](void* data, std::size_t size) {
+    if (buf.size() - pos < size)
+      throw std::runtime_error{"truncated"};
+    std::memcpy(data, buf.data() + pos, size);
+    pos += size;
+  };
+  auto get32 = [&get]() { std::uint32_t n; get(&n, sizeof(n)); return n; };
+  auto get64 = [&get]() { std::uint64_t n; get(&n, sizeof(n)); return n; };
+  auto get_str = [&]() {
+    auto n = get32();
+    if (buf.size() - pos < n)
+      throw std::runtime_error{"truncated"};
+    pos += n;
+    return buf.substr(pos - n, n);
+  };
+  try {
+    if (get32() != CacheMagic || get32() != CacheVersion)
+      return;
+    for (auto count = get32(); count != 0; --count) {
+      auto name = get_str();
+      auto rec = std::make_shared<Record>();
+      rec->hash = get64();
+      rec->defs = get64();
+      rec->ops.resize(get32());
+      for (auto& op: rec->ops) {
+	std::uint8_t kind;
+	get(&kind, sizeof(kind));
+	if (kind > Op::once)
+	  throw std::runtime_error{"invalid op"};
+	op.kind = Op::Kind(kind);
+	op.name = get_str();
+	op.text = get_str();
+	get(&op.nutr, sizeof(op.nutr));
+	op.hash = get64();
+      }
+      cached[name].push_back(std::move(rec));
+    }
+  }
+  catch (const std::exception&) {
+    cached.clear();
+  }
+} // load
+
+void Ingredients::save(const std::string& fname) const {
+  std::string buf;
+  auto put = [&buf](const void* data, std::size_t size)
+    { buf.append(static_cast<const char*>(data), size); };
+  auto put32 = [&put](std::uint32_t n) { put(&n, sizeof(n)); };
+  auto put64 = [&put](std::uint64_t n) { put(&n, sizeof(n)); };
+  auto put_str = [&](std::string_view str) {
+    put32(std::uint32_t(str.size()));
+    put(str.data(), str.size());
+  };
+  put32(CacheMagic);
+  put32(CacheVersion);
+  std::uint32_t count = 0;
+  for (const auto& [name, recs]: used)
+    count += std::uint32_t(recs.size());
+  put32(count);
+  for (const auto& [name, recs]: used) {
+    for (const auto& rec: recs) {
+      put_str(name);
+      put64(rec->hash);
+      put64(rec->defs);
+      put32(std::uint32_t(rec->ops.size()));
+      for (const auto& op: rec->ops) {
+	buf.push_back(char(op.kind));
+	put_str(op.name);
+	put_str(op.text);
+	put(&op.nutr, sizeof(op.nutr));
+	put64(op.hash);
+      }
+    }
+  }
+  ReplaceFile(fname, buf);
+} // save
@@ -0,0 +1,166 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef INGREDIENTS_H
+#define INGREDIENTS_H
+#pragma once
+
+#include "Nutrition.h"
+#include "NutritionTable.h"
+#include "NameIndex.h"
+#include "Macros.h"
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <regex>
+#include <sstream>
+#include <cstdint>
+
+// digest's state: the ingredients and #defines read so far, and its
+// messages.  Every read and change made while parsing a file is recorded,
+// along with a hash of the file and of the #defines it started with.  On
+// the next run, a file whose text and starting #defines are unchanged is
+// replayed from its record instead of being parsed; if anything it reads
+// turns out to differ, its changes are rolled back and it is parsed after
+// all.  Within a run, a file included again with the same #defines is
+// replayed without being read again.  Records are kept in a cache file
+// between runs.  The files of a run of #includes are parsed ahead, a few
+// at a time and concurrently, each as if it were read next; reading them
+// in turn replays those that did not depend on one another.
+class Ingredients {
+public:
+  // Parses fname into db, beginning with db.replay() or db.begin().
+  using Reader = void (*)(const std::string& fname, Ingredients& db);
+
+  struct Op {
+    enum Kind : std::uint8_t {
+      output,       // name: message
+      include,      // name: file
+      define,       // name = text
+      undef,        // name
+      defs,         // hash: of the #defines, after an #include
+      find,         // name: hash 1 and nutr if found
+      insert,       // name, nutr: hash 1 if already present
+      assign,       // name = nutr
+      fingerprint,  // hash: of all ingredients, before a /search/
+      emplace,      // name, nutr: if not present
+      once          // name: #pragma once
+    }; // Kind
+    Kind kind = output;
+    std::string name{};
+    std::string text{};
+    Nutrition nutr{};
+    std::uint64_t hash = 0;
+  }; // Op
+
+  struct Record {
+    std::uint64_t hash = 0;  // of the file
+    std::uint64_t defs = 0;  // of the #defines at the start
+    std::vector<Op> ops;
+  }; // Record
+
+private:
+  struct Run {
+    std::vector<std::string> fnames;  // to be read, last first
+    std::size_t parsed = 0;           // of them, parsed ahead
+    std::uint64_t defs = 0;           // with these #defines
+  }; // Run
+
+  struct Frame {
+    std::string fname;
+    std::shared_ptr<Record> record;  // null while replaying
+    std::size_t nuts_mark = 0;
+    std::size_t defs_mark = 0;
+    std::size_t report_mark = 0;
+    std::size_t once_mark = 0;
+  }; // Frame
+
+  Reader reader;
+  const Ingredients* base = nullptr;  // while parsing ahead
+  bool spoiled = false;               // by a /search/, while parsing ahead
+  NutritionTable nuts;
+  NameIndex index;
+  TextMap _defs;
+  std::uint64_t nuts_hash = 0;
+  std::uint64_t defs_hash = 0;
+  std::ostringstream _log;
+  std::string report;
+  std::vector<Frame> frames;
+  int replaying = 0;
+  std::vector<std::pair<std::string, std::optional<Nutrition>>> nuts_undo;
+  std::vector<std::pair<std::string, std::optional<std::string>>> defs_undo;
+  std::vector<std::string> once_files;
+  std::vector<std::string> _files;  // read this run
+  // file --> its records, one per starting #defines
+  using Records = std::map<std::string,
+			   std::vector<std::shared_ptr<const Record>>,
+			   std::less<>>;
+  Records cached;  // from the cache file
+  Records used;    // parsed or replayed this run
+  Records ahead;   // parsed ahead this run
+  std::vector<Run> runs;  // of #includes, innermost last
+
+  Ingredients(Reader reader_, const Ingredients& base_);
+  const Nutrition* lookup(const std::string& name) const;
+  void flush(bool record);
+  void record(Op op);
+  void put(const std::string& name, const Nutrition& nutr, bool replace);
+  void set(const std::string& var, std::optional<std::string> val);
+  bool apply(const Op& op);
+  void rollback(const Frame& frame);
+  Frame mark(const std::string& fname, std::shared_ptr<Record> rec) const;
+  bool replay(const std::string& fname, std::shared_ptr<const Record> rec);
+  void keep(const std::string& fname, std::shared_ptr<const Record> rec);
+  void parse_ahead(Run& run);
+
+public:
+  explicit Ingredients(Reader reader_) : reader{reader_} { }
+
+  const NutritionTable& table() const { return nuts; }
+  const TextMap& defs() const { return _defs; }
+  // Messages about the file being parsed.
+  std::ostream& log() { return _log; }
+  // All messages, in order.
+  const std::string& messages() { flush(false); return report; }
+
+  // Reads fname, which may be replayed from the cache.
+  void read(const std::string& fname);
+  // fnames are about to be read in turn: parse them ahead on a pool of
+  // threads.  Each starts with the ingredients and #defines as they are
+  // when the first of those parsed with it is read, so one that reads what
+  // another adds or changes, or that does a /search/, is parsed again.
+  void prefetch(const std::vector<std::string>& fnames);
+  // Every file read, or found missing, in this run.
+  const std::vector<std::string>& files() const { return _files; }
+  // True if a file read in this run now differs from what was read, or
+  // one found missing now exists.
+  bool changed() const;
+  // Forgets the ingredients and #defines, keeping this run's records as
+  // the cache for the next run.
+  void restart();
+
+  // For the reader: replays fname if it can, or else begins to record it,
+  // to be ended by end().
+  bool replay(const std::string& fname, std::string_view text);
+  void begin(const std::string& fname, std::string_view text);
+  void end();
+
+  // Recorded reads and changes.
+  const Nutrition* find(const std::string& name);
+  bool insert(const std::string& name, const Nutrition& nutr);
+  void assign(const std::string& name, const Nutrition& nutr);
+  void search(const std::regex& re, std::string_view literal,
+	      const std::string& replacement);
+  void define(const std::string& var, const std::string& val);
+  void undef(const std::string& var);
+  // #pragma once: the file being parsed is not read again in this run.
+  void pragma_once();
+
+  // The cache file; a missing or unreadable cache is ignored.
+  void load(const std::string& fname);
+  void save(const std::string& fname) const;
+}; // Ingredients
+
+#endif
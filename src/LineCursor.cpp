@@ -0,0 +1,168 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "LineCursor.h"
+
+#include <charconv>
+#include <limits>
+#include <cstdlib>
+#include <cstdio>
+
+namespace {
+
+bool IsDigit(char c) { return (c >= '0' && c <= '9'); }
+
+} // local
+
+bool LineCursor::sentry(bool skip_ws) {
+  if (!good()) {
+    _fail = true;
+    return false;
+  }
+  if (skip_ws) {
+    skip();
+    if (pos == str.size()) {
+      _eof = _fail = true;
+      return false;
+    }
+  }
+  return true;
+} // sentry
+
+int LineCursor::peek() {
+  if (!sentry(false))
+    return EOF;
+  if (pos == str.size()) {
+    _eof = true;
+    return EOF;
+  }
+  return static_cast<unsigned char>(str[pos]);
+} // peek
+
+void LineCursor::ignore() {
+  if (!sentry(false))
+    return;
+  if (pos == str.size())
+    _eof = true;
+  else
+    ++pos;
+} // ignore
+
+LineCursor& LineCursor::ws() {
+  if (sentry(false)) {
+    skip();
+    if (pos == str.size())
+      _eof = true;
+  }
+  return *this;
+} // ws
+
+LineCursor& LineCursor::operator>>(float& x) {
+  if (!sentry(true))
+    return *this;
+  // Take the characters num_get would: a sign, digits with at most one
+  // point, and an exponent only after a digit.
+  auto i = pos;
+  if (str[i] == '+' || str[i] == '-')
+    ++i;
+  bool mantissa = false;
+  bool point = false;
+  bool sci = false;
+  while (i != str.size()) {
+    const char c = str[i];
+    if (IsDigit(c)) {
+      mantissa = true;
+    }
+    else if (c == '.' && !point && !sci) {
+      point = true;
+    }
+    else if ((c == 'e' || c == 'E') && !sci && mantissa) {
+      sci = true;
+      if (i + 1 != str.size() && (str[i + 1] == '+' || str[i + 1] == '-'))
+	++i;
+    }
+    else {
+      break;
+    }
+    ++i;
+  }
+  const auto field = str.substr(pos, i - pos);
+  pos = i;
+  if (pos == str.size())
+    _eof = true;
+
+  // All of them must convert, as with strtof().
+  auto first = field.data();
+  const auto last = first + field.size();
+  if (first != last && *first == '+')
+    ++first;
+  float val = 0.0f;
+  auto [ptr, ec] = std::from_chars(first, last, val);
+  if (ptr != last || (ec != std::errc{}
+		      && ec != std::errc::result_out_of_range)) {
+    x = 0.0f;
+    _fail = true;
+  }
+  else if (ec == std::errc{}) {
+    x = val;
+  }
+  else {
+    // Too small is rounded to zero, but too big fails, at the largest.
+    val = std::strtof(std::string{field}.c_str(), nullptr);
+    constexpr auto Max = std::numeric_limits<float>::max();
+    constexpr auto Inf = std::numeric_limits<float>::infinity();
+    if (val == Inf || val == -Inf) {
+      x = (val < 0.0f) ? -Max : Max;
+      _fail = true;
+    }
+    else {
+      x = val;
+    }
+  }
+  return *this;
+} // >> float
+
+LineCursor& LineCursor::quoted(std::string& s) {
+  if (!sentry(true))
+    return *this;
+  if (str[pos] != '"') {
+    // An unquoted word.
+    const auto start = pos;
+    while (pos != str.size() && !IsSpace(str[pos]))
+      ++pos;
+    s.assign(str.substr(start, pos - start));
+    if (pos == str.size())
+      _eof = true;
+    return *this;
+  }
+  ++pos;
+  s.clear();
+  for (;;) {
+    if (pos == str.size()) {
+      _eof = _fail = true;
+      break;
+    }
+    char c = str[pos++];
+    if (c == '\\') {
+      if (pos == str.size()) {
+	_eof = _fail = true;
+	break;
+      }
+      c = str[pos++];
+    }
+    else if (c == '"') {
+      break;
+    }
+    s += c;
+  }
+  return *this;
+} // quoted
+
+LineCursor& LineCursor::getline(std::string& s) {
+  if (!sentry(false))
+    return *this;
+  s.assign(rest());
+  pos = str.size();
+  _eof = true;
+  if (s.empty())
+    _fail = true;
+  return *this;
+} // getline
@@ -0,0 +1,47 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef LINECURSOR_H
+#define LINECURSOR_H
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Reads the fields of a line as an std::istringstream of it would, down to
+// when its eof and fail states are set, so that the same lines are found
+// invalid, but without the stream.  Numbers are converted by from_chars.
+class LineCursor {
+  std::string_view str;
+  std::size_t pos = 0;
+  bool _eof  = false;
+  bool _fail = false;
+
+  static bool IsSpace(char c) {
+    return (c == ' ' || c == '\t' || c == '\n' || c == '\r'
+	    || c == '\f' || c == '\v');
+  }
+  void skip() { while (pos != str.size() && IsSpace(str[pos])) ++pos; }
+  // As istream's sentry: fails unless good(), then may skip whitespace.
+  bool sentry(bool skip_ws);
+
+public:
+  explicit LineCursor(std::string_view str_) : str{str_} { }
+
+  explicit operator bool() const { return !_fail; }
+  bool eof()  const { return _eof; }
+  bool good() const { return !_eof && !_fail; }
+  // What is left to read.
+  std::string_view rest() const { return str.substr(pos); }
+
+  int peek();
+  void ignore();
+  // >> std::ws
+  LineCursor& ws();
+  LineCursor& operator>>(float& x);
+  // >> std::quoted(s)
+  LineCursor& quoted(std::string& s);
+  // std::getline(), of the rest of the line.
+  LineCursor& getline(std::string& s);
+}; // LineCursor
+
+#endif
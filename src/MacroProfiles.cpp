@@ -0,0 +1,88 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "MacroProfiles.h"
+
+#include <ranges>
+#include <algorithm>
+#include <cmath>
+
+namespace rng = std::ranges;
+
+MacroProfiles::MacroProfiles(const IngredDb& db, ProfileBasis basis)
+  : _basis{basis}, rows(db.size(), -1)
+{
+  for (gsl::index i = 0; i != db.size(); ++i) {
+    const auto& n = db.nutr(i);
+    const auto per = (basis == ProfileBasis::kcal) ? n.kcal / 100.0f
+						   : std::abs(n.g);
+    if (!(per > 0.0f))
+      continue;
+    rows[i] = gsl::narrow<std::int32_t>(ids.size());
+    ids.push_back(gsl::narrow<std::uint32_t>(i));
+    // As nut does, a negative fiber is alcohol, not fiber.
+    const Profile p = { n.prot, n.fat, n.carb, std::max(0.0f, n.fiber) };
+    for (int m = 0; m != Macros; ++m)
+      cols[m].push_back(p[m] / per);
+  }
+
+  for (int m = 0; m != Macros; ++m) {
+    auto& col = cols[m];
+    double sum = 0.0, sum2 = 0.0;
+    for (auto x: col) {
+      sum  += x;
+      sum2 += double{x} * x;
+    }
+    const auto n = std::max<double>(col.size(), 1.0);
+    const auto var = sum2 / n - (sum / n) * (sum / n);
+    scale[m] = (var > 0.0) ? float(std::sqrt(var)) : 1.0f;
+    for (auto& x: col)
+      x /= scale[m];
+  }
+} // ctor
+
+auto MacroProfiles::profile(gsl::index i) const -> Profile {
+  Profile p{};
+  if (has(i)) {
+    for (int m = 0; m != Macros; ++m)
+      p[m] = cols[m][rows[i]] * scale[m];
+  }
+  return p;
+} // profile
+
+auto MacroProfiles::nearest(gsl::index i, std::size_t k) const
+  -> std::vector<Neighbor>
+{
+  if (!has(i))
+    return {};
+  const auto row = rows[i];
+  const auto n = ids.size();
+
+  // Squared distances, a column at a time.
+  std::vector<float> dist(n, 0.0f);
+  for (int m = 0; m != Macros; ++m) {
+    const float* col = cols[m].data();
+    const float q = col[row];
+    float* d = dist.data();
+    for (std::size_t r = 0; r != n; ++r) {
+      const float x = col[r] - q;
+      d[r] += x * x;
+    }
+  }
+
+  std::vector<std::uint32_t> order;
+  order.reserve(n);
+  for (std::uint32_t r = 0; r != n; ++r) {
+    if (r != std::uint32_t(row))
+      order.push_back(r);
+  }
+  auto nearer = [&dist](std::uint32_t lhs, std::uint32_t rhs) {
+    return (dist[lhs] != dist[rhs]) ? dist[lhs] < dist[rhs] : lhs < rhs;
+  };
+  k = std::min(k, order.size());
+  rng::partial_sort(order, order.begin() + k, nearer);
+
+  std::vector<Neighbor> found;
+  found.reserve(k);
+  for (auto r: order | std::views::take(k))
+    found.push_back(Neighbor{ids[r], std::sqrt(dist[r])});
+  return found;
+} // nearest
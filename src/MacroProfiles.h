@@ -0,0 +1,62 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef MACRO_PROFILES_H
+#define MACRO_PROFILES_H
+#pragma once
+
+#include "IngredDb.h"
+
+#include <gsl/gsl>
+
+#include <array>
+#include <string_view>
+#include <optional>
+#include <vector>
+#include <cstdint>
+
+// What a macro profile is measured against: per 100 kcal or per gram.
+enum class ProfileBasis : std::uint8_t { kcal, g };
+
+constexpr std::string_view ProfileBasisNames[] = { "kcal", "g" };
+
+constexpr std::optional<ProfileBasis> ParseBasis(std::string_view name) {
+  for (std::size_t i = 0; i != std::size(ProfileBasisNames); ++i) {
+    if (ProfileBasisNames[i] == name)
+      return ProfileBasis(i);
+  }
+  return std::nullopt;
+} // ParseBasis
+
+// The protein, fat, carb and fiber of every ingredient in an IngredDb
+// that has the basis (kcal or weight), each macro in its own column and
+// divided by the column's standard deviation, so that the squared
+// distance between two profiles weighs each macro alike.  A search is a
+// brute-force pass over the columns, which the compiler vectorizes.
+class MacroProfiles {
+public:
+  static constexpr int Macros = 4;  // prot, fat, carb, fiber
+  using Profile = std::array<float, Macros>;
+private:
+  ProfileBasis _basis;
+  std::vector<std::uint32_t> ids;  // IngredDb index of each row
+  std::vector<std::int32_t> rows;  // row of each IngredDb index, or -1
+  std::array<std::vector<float>, Macros> cols;
+  Profile scale{};  // of each column, to undo the normalization
+public:
+  MacroProfiles(const IngredDb& db, ProfileBasis basis);
+  ProfileBasis basis() const { return _basis; }
+  gsl::index size() const { return ids.size(); }
+  // Whether ingredient i has a profile: it has kcal (or weight).
+  bool has(gsl::index i) const { return (rows[i] >= 0); }
+  // Ingredient i's macros per 100 kcal (or per gram).
+  Profile profile(gsl::index i) const;
+
+  struct Neighbor {
+    gsl::index ingredient = 0;
+    float distance = 0.0f;  // in standard deviations
+  }; // Neighbor
+  // The k ingredients whose profiles are nearest ingredient i's, nearest
+  // first, not counting i.
+  std::vector<Neighbor> nearest(gsl::index i, std::size_t k) const;
+}; // MacroProfiles
+
+#endif
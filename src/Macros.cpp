@@ -0,0 +1,71 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "Macros.h"
+
+namespace {
+
+constexpr bool IsWord(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+      || (c >= '0' && c <= '9') || c == '_';
+} // IsWord
+
+// Replaces each word in str that is a key of map, and is preceded by
+// prefix if prefix is not '\0', with its value, in a single scan.
+bool Substitute(std::string& str, const TextMap& map, char prefix) {
+  if (map.empty())
+    return false;
+  const auto in = std::string_view{str};
+  std::string out;
+  bool started = false;
+  std::size_t done = 0;
+  for (std::size_t i = 0; i != in.size(); ) {
+    if (!IsWord(in[i])) {
+      ++i;
+      continue;
+    }
+    auto e = i;
+    while (e != in.size() && IsWord(in[e]))
+      ++e;
+    auto s = (prefix && i != 0 && in[i-1] == prefix) ? i - 1 : i;
+    if (prefix == '\0' || s != i) {
+      if (auto it = map.find(in.substr(i, e - i)); it != map.end()) {
+	if (!started) {
+	  out.reserve(in.size() + it->second.size());
+	  started = true;
+	}
+	out.append(in.substr(done, s - done));
+	out.append(it->second);
+	done = e;
+      }
+    }
+    i = e;
+  }
+  if (!started)
+    return false;
+  out.append(in.substr(done));
+  str.swap(out);
+  return true;
+} // Substitute
+
+} // local
+
+bool ExpandDefines(std::string& str, const TextMap& defs)
+{ return Substitute(str, defs, '\0'); }
+
+bool ExpandVars(std::string& str, const TextMap& vars,
+		std::string_view dollars)
+{
+  auto i = str.find('$');
+  if (i == std::string::npos)
+    return true;
+  bool ok = true;
+  if (i = str.find("$$", i); i != std::string::npos) {
+    if (dollars.empty())
+      ok = false;
+    else {
+      for (; i != std::string::npos; i = str.find("$$", i + dollars.size()))
+	str.replace(i, 2, dollars);
+    }
+  }
+  Substitute(str, vars, '$');
+  return ok;
+} // ExpandVars
@@ -0,0 +1,36 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef MACROS_H
+#define MACROS_H
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <functional>
+#include <cstddef>
+
+// digest's #define and $var substitution, done by scanning each line once
+// and looking words up in a hash map.  A word is a maximal run of
+// [A-Za-z0-9_], as \w in the ECMAScript regex grammar.
+
+struct StringHash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view str) const
+  { return std::hash<std::string_view>{}(str); }
+}; // StringHash
+
+// Name --> text, searchable by string_view.
+using TextMap
+  = std::unordered_map<std::string, std::string, StringHash, std::equal_to<>>;
+
+// Replaces every word that names a define with its value.  Values are not
+// themselves rescanned.  Returns true if str changed.
+bool ExpandDefines(std::string& str, const TextMap& defs);
+
+// Replaces "$$" with dollars and then each "$var" with the value of var,
+// in one scan for each.  Unknown $vars are left alone.  Returns false if
+// str used "$$" but dollars is empty.
+bool ExpandVars(std::string& str, const TextMap& vars,
+		std::string_view dollars);
+
+#endif
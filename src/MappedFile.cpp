@@ -0,0 +1,95 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "MappedFile.h"
+
+#include <system_error>
+#include <utility>
+#include <string>
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+class Fd {
+  int fd;
+public:
+  explicit Fd(int fd_) : fd{fd_} { }
+  ~Fd() { if (fd >= 0) ::close(fd); }
+  operator int() const { return fd; }
+  int release() { return std::exchange(fd, -1); }
+}; // Fd
+
+[[noreturn]] void ThrowErrno(const std::string& what)
+{ throw std::system_error{errno, std::generic_category(), what}; }
+
+} // local
+
+MappedFile::MappedFile(const std::string& fname) {
+  auto fd = Fd{::open(fname.c_str(), O_RDONLY | O_CLOEXEC)};
+  if (fd < 0)
+    ThrowErrno(fname + ": cannot read");
+  struct stat st;
+  if (::fstat(fd, &st) != 0)
+    ThrowErrno(fname + ": cannot stat");
+  _size = static_cast<std::size_t>(st.st_size);
+  if (_size == 0)
+    return;
+  auto addr = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    _size = 0;
+    ThrowErrno(fname + ": cannot map");
+  }
+  _data = static_cast<const char*>(addr);
+} // ctor
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept {
+  if (this != &rhs) {
+    MappedFile tmp{std::move(*this)};
+    _data = std::exchange(rhs._data, nullptr);
+    _size = std::exchange(rhs._size, 0);
+  }
+  return *this;
+} // move assignment
+
+MappedFile::~MappedFile() {
+  if (_data)
+    ::munmap(const_cast<char*>(_data), _size);
+} // dtor
+
+void ReplaceFile(const std::string& fname, std::string_view data) {
+  const auto tmp = fname + ".tmp" + std::to_string(::getpid());
+  auto fail = [&tmp](const std::string& what) {
+    auto err = errno;
+    ::unlink(tmp.c_str());
+    errno = err;
+    ThrowErrno(what);
+  };
+  {
+    auto fd = Fd{::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+			0666)};
+    if (fd < 0)
+      ThrowErrno(tmp + ": cannot create");
+    auto p = data.data();
+    auto n = data.size();
+    while (n != 0) {
+      auto w = ::write(fd, p, n);
+      if (w < 0 && errno == EINTR)
+	continue;
+      if (w < 0)
+	fail(tmp + ": cannot write");
+      p += w;
+      n -= std::size_t(w);
+    }
+    // On disk before it has the real name, so a crash cannot leave an
+    // empty or short file there.
+    if (::fsync(fd) != 0)
+      fail(tmp + ": cannot sync");
+    if (::close(fd.release()) != 0)
+      fail(tmp + ": cannot write");
+  }
+  if (::rename(tmp.c_str(), fname.c_str()) != 0)
+    fail(fname + ": cannot replace");
+} // ReplaceFile
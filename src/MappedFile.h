@@ -0,0 +1,35 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Read-only memory mapping of an entire file.
+class MappedFile {
+  const char* _data = nullptr;
+  std::size_t _size = 0;
+public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string& fname);
+  MappedFile(MappedFile&& rhs) noexcept
+    : _data{rhs._data}, _size{rhs._size}
+    { rhs._data = nullptr; rhs._size = 0; }
+  MappedFile& operator=(MappedFile&& rhs) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+  const char* data() const { return _data; }
+  std::size_t size() const { return _size; }
+  bool empty() const { return (_size == 0); }
+  std::string_view view() const { return std::string_view{_data, _size}; }
+}; // MappedFile
+
+// Replaces fname with data by writing and syncing a temporary file beside
+// it and renaming that over fname, so that readers, including those that
+// have fname mapped, see the old file or the new one but never a mix.
+void ReplaceFile(const std::string& fname, std::string_view data);
+
+#endif
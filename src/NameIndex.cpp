@@ -0,0 +1,177 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "NameIndex.h"
+
+#include <ranges>
+#include <algorithm>
+
+namespace rng = std::ranges;
+
+namespace {
+
+constexpr bool IsAlnum(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+      || (c >= '0' && c <= '9');
+} // IsAlnum
+
+std::uint32_t Trigram(std::string_view str, std::size_t i) {
+  return (std::uint32_t(std::uint8_t(str[i])) << 16)
+       | (std::uint32_t(std::uint8_t(str[i+1])) << 8)
+       |  std::uint32_t(std::uint8_t(str[i+2]));
+} // Trigram
+
+// The index just past the ')' or ']' that closes the group or class
+// opening at re[i], or npos.
+std::size_t SkipNested(std::string_view re, std::size_t i) {
+  int depth = 0;
+  bool in_class = false;
+  for (; i != re.size(); ++i) {
+    auto c = re[i];
+    if (c == '\\') {
+      if (++i == re.size())
+	break;
+      continue;
+    }
+    if (in_class) {
+      if (c == ']') {
+	in_class = false;
+	if (depth == 0)
+	  return i + 1;
+      }
+    }
+    else if (c == '[')
+      in_class = true;
+    else if (c == '(')
+      ++depth;
+    else if (c == ')' && --depth == 0)
+      return i + 1;
+  }
+  return std::string_view::npos;
+} // SkipNested
+
+} // local
+
+std::string RequiredLiteral(std::string_view re) {
+  if (re.find('|') != std::string_view::npos)
+    return {};
+  std::string best;
+  std::string run;
+  auto end_run = [&]() {
+    if (run.size() > best.size())
+      best = run;
+    run.clear();
+  };
+  for (std::size_t i = 0; i != re.size(); ) {
+    // One atom: a literal character, or something that ends the run.
+    bool literal = false;
+    auto c = re[i];
+    if (c == '\\') {
+      if (i + 1 == re.size())
+	return {};
+      c = re[i+1];
+      if (IsAlnum(c)) {
+	// \b \B \d \D \s \S \w \W; give up on \1, \n, \x41, é, \cJ...
+	if (std::string_view{"bBdDsSwW"}.find(c) == std::string_view::npos)
+	  return {};
+      }
+      else
+	literal = true;
+      i += 2;
+    }
+    else if (c == '(' || c == '[') {
+      i = SkipNested(re, i);
+      if (i == std::string_view::npos)
+	return {};
+    }
+    else if (c == ')' || c == ']' || c == '}'
+	     || c == '*' || c == '+' || c == '?' || c == '{') {
+      return {};
+    }
+    else {
+      literal = (c != '.' && c != '^' && c != '$');
+      ++i;
+    }
+    if (literal)
+      run += c;
+
+    // A quantifier: the atom may be absent (*, ?, {0,}) or repeated (+).
+    if (i == re.size())
+      break;
+    c = re[i];
+    if (c == '*' || c == '?' || c == '{') {
+      if (literal)
+	run.pop_back();
+      if (c == '{') {
+	i = re.find('}', i);
+	if (i == std::string_view::npos)
+	  return {};
+      }
+      ++i;
+    }
+    else if (c == '+') {
+      ++i;
+    }
+    else {
+      if (!literal)
+	end_run();
+      continue;
+    }
+    end_run();
+    if (i != re.size() && re[i] == '?')  // lazy
+      ++i;
+  }
+  end_run();
+  return best;
+} // RequiredLiteral
+
+void NameIndex::add(std::string_view name) {
+  const auto id = std::uint32_t(names.size());
+  names.push_back(name);
+  for (std::size_t i = 0; i + Gram <= name.size(); ++i) {
+    auto& list = postings[Trigram(name, i)];
+    if (list.empty() || list.back() != id)
+      list.push_back(id);
+  }
+} // NameIndex::add
+
+void NameIndex::pop_back() {
+  const auto id = std::uint32_t(names.size() - 1);
+  const auto name = names.back();
+  for (std::size_t i = 0; i + Gram <= name.size(); ++i) {
+    auto iter = postings.find(Trigram(name, i));
+    if (iter == postings.end() || iter->second.back() != id)
+      continue;  // a repeated trigram
+    iter->second.pop_back();
+    if (iter->second.empty())
+      postings.erase(iter);
+  }
+  names.pop_back();
+} // NameIndex::pop_back
+
+std::vector<std::string_view>
+NameIndex::candidates(std::string_view literal) const
+{
+  std::vector<const std::vector<std::uint32_t>*> lists;
+  for (std::size_t i = 0; i + Gram <= literal.size(); ++i) {
+    auto iter = postings.find(Trigram(literal, i));
+    if (iter == postings.end())
+      return {};
+    lists.push_back(&iter->second);
+  }
+  if (lists.empty())
+    return {};
+  rng::sort(lists, {}, [](auto list) { return list->size(); });
+  auto ids = *lists.front();
+  for (auto list: lists | std::views::drop(1)) {
+    if (ids.empty())
+      break;
+    if (list == lists.front())
+      continue;
+    std::erase_if(ids, [list](auto id)
+		  { return !rng::binary_search(*list, id); });
+  }
+  std::vector<std::string_view> rval;
+  rval.reserve(ids.size());
+  for (auto id: ids)
+    rval.push_back(names[id]);
+  return rval;
+} // NameIndex::candidates
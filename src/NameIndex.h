@@ -0,0 +1,41 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// A trigram index over ingredient names, so that digest's /search/replace/
+// need only test the names that can possibly match.
+
+// The longest run of characters that every match of the ECMAScript regex
+// must contain, or "" if none is found.  Conservative: alternation,
+// back-references and numeric escapes give "".
+std::string RequiredLiteral(std::string_view regex);
+
+class NameIndex {
+public:
+  static constexpr std::size_t Gram = 3;
+
+  // name must outlive the index.
+  void add(std::string_view name);
+  // Removes the name added last.
+  void pop_back();
+
+  // The names that contain every trigram of literal, in the order added.
+  // literal must be at least Gram characters.
+  std::vector<std::string_view> candidates(std::string_view literal) const;
+
+  std::size_t size() const { return names.size(); }
+
+private:
+  std::vector<std::string_view> names;
+  // trigram --> ascending indices into names
+  std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> postings;
+}; // NameIndex
+
+#endif
@@ -0,0 +1,224 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "Normalize.h"
+
+#include <ranges>
+#include <algorithm>
+#include <span>
+#include <cstring>
+
+namespace rng = std::ranges;
+
+namespace {
+
+// Word characters, as matched by \w in the ECMAScript regex grammar.
+constexpr bool IsWord(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+      || (c >= '0' && c <= '9') || c == '_';
+} // IsWord
+
+struct Rule {
+  std::string_view from;
+  std::string_view to;
+  constexpr bool grows() const { return (to.size() > from.size()); }
+}; // Rule
+
+// Replacements are never themselves rewritten.
+constexpr Rule Synonyms[] = {
+  { "diced",    "chopped" },
+  { "cubed",    "chopped" },
+  { "servings", "serving" }
+}; // Synonyms
+
+constexpr Rule LookupSynonyms[] = {
+  { "diced",    "chopped" },
+  { "cubed",    "chopped" },
+  { "servings", "serving" },
+  { "dry",      "dried"   }
+}; // LookupSynonyms
+
+constexpr std::string_view Sizes[] = { "small", "large", "light", "heavy" };
+
+const Rule* FindRule(std::span<const Rule> rules, std::string_view word) {
+  for (const auto& r: rules) {
+    if (r.from == word)
+      return &r;
+  }
+  return nullptr;
+} // FindRule
+
+// Replaces whole words (maximal runs of word characters) found in rules
+// and, optionally, every '-' with ' '.  Words that shrink are rewritten
+// in a forward pass and words that grow in a backward pass, so the string
+// is edited in place and only grows, at most once, past its capacity.
+bool RewriteWords(std::string& str, std::span<const Rule> rules,
+		  bool hyphens)
+{
+  std::size_t grow = 0;
+  bool changed = hyphens && (str.find('-') != std::string::npos);
+  const auto n = str.size();
+  for (std::size_t r = 0; r != n; ) {
+    if (!IsWord(str[r])) {
+      ++r;
+      continue;
+    }
+    auto s = r;
+    while (r != n && IsWord(str[r]))
+      ++r;
+    if (auto rule = FindRule(rules, std::string_view{str}.substr(s, r-s))) {
+      changed = true;
+      if (rule->grows())
+	grow += rule->to.size() - rule->from.size();
+    }
+  }
+  if (!changed)
+    return false;
+
+  char* p = str.data();
+  std::size_t w = 0;
+  for (std::size_t r = 0; r != n; ) {
+    if (!IsWord(p[r])) {
+      auto c = p[r++];
+      p[w++] = (hyphens && c == '-') ? ' ' : c;
+      continue;
+    }
+    auto s = r;
+    while (r != n && IsWord(p[r]))
+      ++r;
+    auto word = std::string_view{p + s, r - s};
+    auto rule = FindRule(rules, word);
+    if (rule && !rule->grows())
+      word = rule->to;
+    std::memmove(p + w, word.data(), word.size());
+    w += word.size();
+  }
+  str.resize(w);
+  if (grow == 0)
+    return true;
+
+  auto r = str.size();
+  str.resize(r + grow);
+  p = str.data();
+  w = str.size();
+  while (r != 0) {
+    if (!IsWord(p[r-1])) {
+      p[--w] = p[--r];
+      continue;
+    }
+    auto e = r;
+    while (r != 0 && IsWord(p[r-1]))
+      --r;
+    auto word = std::string_view{p + r, e - r};
+    auto rule = FindRule(rules, word);
+    if (rule && rule->grows())
+      word = rule->to;
+    w -= word.size();
+    std::memmove(p + w, word.data(), word.size());
+  }
+  return true;
+} // RewriteWords
+
+} // local
+
+bool ExpandExtra(std::string& name) {
+  if (name.find("extra") == std::string::npos)
+    return false;
+  // "extra", one ' ' or '-', and a size word: always shrinks, so one
+  // forward pass rewrites in place.
+  char* p = name.data();
+  const auto n = name.size();
+  std::size_t w = 0;
+  bool changed = false;
+  for (std::size_t r = 0; r != n; ) {
+    if (!IsWord(p[r])) {
+      p[w++] = p[r++];
+      continue;
+    }
+    auto s = r;
+    while (r != n && IsWord(p[r]))
+      ++r;
+    auto word = std::string_view{p + s, r - s};
+    if (word == "extra" && r + 1 < n && (p[r] == ' ' || p[r] == '-')) {
+      auto e = r + 1;
+      while (e != n && IsWord(p[e]))
+	++e;
+      auto size = std::string_view{p + r + 1, e - r - 1};
+      if (rng::find(Sizes, size) != std::end(Sizes)) {
+	p[w++] = 'x';
+	std::memmove(p + w, size.data(), size.size());
+	w += size.size();
+	r = e;
+	changed = true;
+	continue;
+      }
+    }
+    std::memmove(p + w, word.data(), word.size());
+    w += word.size();
+  }
+  name.resize(w);
+  return changed;
+} // ExpandExtra
+
+bool SubstSynonyms(std::string& name)
+{ return RewriteWords(name, Synonyms, false); }
+
+bool SubstLookupSynonyms(std::string& name)
+{ return RewriteWords(name, LookupSynonyms, true); }
+
+std::optional<std::string> MakePlural(std::string_view name, Plural p) {
+  if (name.empty())
+    return std::nullopt;
+  auto rval = std::string{name};
+  switch (p) {
+    case Plural::none:
+      return rval;
+    case Plural::s:
+      return rval += 's';
+    case Plural::es:
+      return rval += "es";
+    case Plural::ies:
+      if (name.size() < 2 || name.back() != 'y')
+	break;
+      rval.pop_back();
+      return rval += "ies";
+    default:
+      break;
+  }
+  return std::nullopt;
+} // MakePlural
+
+std::optional<std::string> Singular(std::string_view form, Plural p) {
+  static constexpr std::string_view Suffix[] = { "", "s", "es", "ies" };
+  if (form.empty() || p >= Plural::end)
+    return std::nullopt;
+  const auto sfx = Suffix[int(p)];
+  if (form.size() <= sfx.size() || !form.ends_with(sfx))
+    return std::nullopt;
+  form.remove_suffix(sfx.size());
+  auto rval = std::string{form};
+  if (p == Plural::ies)
+    rval += 'y';
+  return rval;
+} // Singular
+
+bool IsPlural(std::string_view form, std::string_view name, Plural p) {
+  if (name.empty())
+    return false;
+  switch (p) {
+    case Plural::none:
+      return (form == name);
+    case Plural::s:
+      return (form.size() == name.size() + 1
+	      && form.starts_with(name) && form.back() == 's');
+    case Plural::es:
+      return (form.size() == name.size() + 2
+	      && form.starts_with(name) && form.ends_with("es"));
+    case Plural::ies:
+      if (name.size() < 2 || name.back() != 'y')
+	return false;
+      name.remove_suffix(1);
+      return (form.size() == name.size() + 3
+	      && form.starts_with(name) && form.ends_with("ies"));
+    default:
+      return false;
+  }
+} // IsPlural
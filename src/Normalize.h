@@ -0,0 +1,38 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef NORMALIZE_H
+#define NORMALIZE_H
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <cstdint>
+
+// Ingredient name rewrites shared by digest (when names are stored) and
+// nut (when recipe lines are matched), so the two cannot drift apart.
+
+// Each returns true if it changed name.
+
+// "extra small" --> "xsmall", likewise large, light and heavy.
+bool ExpandExtra(std::string& name);
+
+// "diced"/"cubed" --> "chopped", "servings" --> "serving".
+bool SubstSynonyms(std::string& name);
+
+// nut's second chance: '-' --> ' ', SubstSynonyms, "dry" --> "dried".
+bool SubstLookupSynonyms(std::string& name);
+
+// nut strips plurals by trying, in order, the name itself, then without
+// "s", without "es", and with "ies" --> "y".  Plural names these rules.
+enum class Plural : std::uint8_t { none, s, es, ies, end };
+
+// Returns the plural of name formed by p, or nullopt if p does not apply.
+std::optional<std::string> MakePlural(std::string_view name, Plural p);
+
+// Returns the name that nut tries for form under p, or nullopt.
+std::optional<std::string> Singular(std::string_view form, Plural p);
+
+// True if form == MakePlural(name, p), without allocating.
+bool IsPlural(std::string_view form, std::string_view name, Plural p);
+
+#endif
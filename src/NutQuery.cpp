@@ -0,0 +1,335 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "NutQuery.h"
+
+#include <ranges>
+#include <algorithm>
+#include <charconv>
+#include <functional>
+#include <utility>
+#include <stdexcept>
+#include <cctype>
+#include <cmath>
+
+namespace rng = std::ranges;
+
+namespace {
+
+// out[i] = f(a[i], b[i]) for a block: a loop the compiler vectorizes.
+template<class F>
+void Apply(float* out, const float* a, const float* b, std::size_t n, F f)
+{
+  for (std::size_t i = 0; i != n; ++i)
+    out[i] = f(a[i], b[i]);
+} // Apply
+
+template<class Cmp>
+constexpr auto Truth(Cmp cmp) {
+  return [cmp](float a, float b) { return cmp(a, b) ? 1.0f : 0.0f; };
+} // Truth
+
+} // local
+
+NutTable::NutTable(const IngredDb& db) {
+  for (auto& col: cols)
+    col.resize(db.size());
+  for (gsl::index i = 0; i != db.size(); ++i) {
+    const auto& n = db.nutr(i);
+    // A negative g marks a weight "each"; it is still the record's weight.
+    const std::array<float, std::size_t(NutField::end)> fields
+      = { std::abs(n.g), n.ml, n.kcal, n.prot, n.fat, n.carb, n.fiber, n.alcohol };
+    for (std::size_t f = 0; f != fields.size(); ++f)
+      cols[f][i] = fields[f];
+  }
+} // ctor
+
+// Recursive descent, emitting postfix code as each operand completes.
+//   or   := and ("or" and)*
+//   and  := not ("and" not)*
+//   not  := "not" not | cmp
+//   cmp  := sum [("<" | "<=" | ">" | ">=" | "==" | "!=") sum]
+//   sum  := term (("+" | "-") term)*
+//   term := unary (("*" | "/") unary)*
+//   unary := "-" unary | number | field | "(" or ")"
+class NutExpr::Parser {
+  std::string_view text;
+  std::size_t pos = 0;
+  std::vector<Code>& code;
+  int height = 0;  // of the evaluation stack, as emitted
+  int& depth;
+
+  [[noreturn]] void fail(const std::string& what) const {
+    throw std::runtime_error{what + " at offset " + std::to_string(pos)
+			     + " in: " + std::string{text}};
+  }
+  void skip_ws() {
+    while (pos != text.size() && std::isspace(static_cast<unsigned char>(text[pos])))
+      ++pos;
+  }
+  // Consumes tok if it is next (a whole word, if tok is one).
+  bool accept(std::string_view tok) {
+    skip_ws();
+    if (!text.substr(pos).starts_with(tok))
+      return false;
+    const auto end = pos + tok.size();
+    auto word = [](char c) { return std::isalnum(static_cast<unsigned char>(c)); };
+    if (word(tok.back()) && end != text.size() && word(text[end]))
+      return false;
+    pos = end;
+    return true;
+  }
+  void emit(Op op) {
+    code.push_back(Code{op});
+    height -= (op == Op::neg || op == Op::not_) ? 0 : 1;
+  }
+  void push(Code c) {
+    code.push_back(c);
+    depth = std::max(depth, ++height);
+  }
+
+  void parse_or() {
+    parse_and();
+    while (accept("or") || accept("||")) {
+      parse_and();
+      emit(Op::or_);
+    }
+  }
+  void parse_and() {
+    parse_not();
+    while (accept("and") || accept("&&")) {
+      parse_not();
+      emit(Op::and_);
+    }
+  }
+  void parse_not() {
+    if (accept("not") || (!text.substr(pos).starts_with("!=")
+			  && accept("!")))
+    {
+      parse_not();
+      emit(Op::not_);
+    }
+    else
+      parse_cmp();
+  }
+  void parse_cmp() {
+    parse_sum();
+    static constexpr std::pair<std::string_view, Op> ops[] = {
+      { "<=", Op::le }, { ">=", Op::ge }, { "==", Op::eq }, { "!=", Op::ne },
+      { "<", Op::lt }, { ">", Op::gt }
+    };
+    for (const auto& [tok, op]: ops) {
+      if (accept(tok)) {
+	parse_sum();
+	emit(op);
+	return;
+      }
+    }
+  }
+  void parse_sum() {
+    parse_term();
+    for (;;) {
+      if (accept("+")) {
+	parse_term();
+	emit(Op::add);
+      }
+      else if (accept("-")) {
+	parse_term();
+	emit(Op::sub);
+      }
+      else
+	return;
+    }
+  }
+  void parse_term() {
+    parse_unary();
+    for (;;) {
+      if (accept("*")) {
+	parse_unary();
+	emit(Op::mul);
+      }
+      else if (accept("/")) {
+	parse_unary();
+	emit(Op::div);
+      }
+      else
+	return;
+    }
+  }
+  void parse_unary() {
+    if (accept("-")) {
+      parse_unary();
+      emit(Op::neg);
+      return;
+    }
+    if (accept("(")) {
+      parse_or();
+      if (!accept(")"))
+	fail("expected )");
+      return;
+    }
+    skip_ws();
+    const char* begin = text.data() + pos;
+    const char* end = text.data() + text.size();
+    if (pos != text.size()
+	&& (std::isdigit(static_cast<unsigned char>(*begin)) || *begin == '.'))
+    {
+      float value = 0.0f;
+      auto [ptr, ec] = std::from_chars(begin, end, value);
+      if (ec != std::errc{})
+	fail("bad number");
+      pos += ptr - begin;
+      push(Code{Op::number, NutField::g, value});
+      return;
+    }
+    auto word_end = pos;
+    while (word_end != text.size()
+	   && std::isalpha(static_cast<unsigned char>(text[word_end])))
+      ++word_end;
+    const auto word = text.substr(pos, word_end - pos);
+    if (word.empty())
+      fail("expected a number, field or (");
+    const auto field = ParseField(word);
+    if (!field)
+      fail("unknown field \"" + std::string{word} + '"');
+    pos = word_end;
+    push(Code{Op::field, *field});
+  }
+
+public:
+  Parser(std::string_view text_, std::vector<Code>& code_, int& depth_)
+    : text{text_}, code{code_}, depth{depth_} { }
+  void parse() {
+    parse_or();
+    skip_ws();
+    if (pos != text.size())
+      fail("unexpected \"" + std::string{text.substr(pos, 1)} + '"');
+  }
+}; // Parser
+
+NutExpr::NutExpr(std::string_view text) : _text{text} {
+  Parser{_text, code, depth}.parse();
+} // ctor
+
+const float* NutExpr::eval(const NutTable& table, gsl::index first,
+			   std::size_t n, std::vector<float>& scratch) const
+{
+  scratch.resize(depth * Block);
+  // arg[k] is the k-th operand on the stack: a slice of a column, or
+  // the k-th block of scratch.
+  std::vector<const float*> arg(depth);
+  int top = -1;
+  for (const auto& c: code) {
+    switch (c.op) {
+      case Op::field:
+	arg[++top] = table.column(c.field) + first;
+	continue;
+      case Op::number: {
+	++top;
+	float* out = scratch.data() + top * Block;
+	std::fill_n(out, n, c.number);
+	arg[top] = out;
+	continue;
+      }
+      case Op::neg:
+      case Op::not_: {
+	const float* a = arg[top];
+	float* out = scratch.data() + top * Block;
+	if (c.op == Op::neg) {
+	  for (std::size_t i = 0; i != n; ++i)
+	    out[i] = -a[i];
+	}
+	else {
+	  for (std::size_t i = 0; i != n; ++i)
+	    out[i] = (a[i] == 0.0f) ? 1.0f : 0.0f;
+	}
+	arg[top] = out;
+	continue;
+      }
+      default:
+	break;
+    }
+    const float* a = arg[top - 1];
+    const float* b = arg[top];
+    float* out = scratch.data() + --top * Block;
+    switch (c.op) {
+      case Op::add: Apply(out, a, b, n, std::plus<float>{});       break;
+      case Op::sub: Apply(out, a, b, n, std::minus<float>{});      break;
+      case Op::mul: Apply(out, a, b, n, std::multiplies<float>{}); break;
+      case Op::div: Apply(out, a, b, n, std::divides<float>{});    break;
+      case Op::lt: Apply(out, a, b, n, Truth(std::less<float>{}));  break;
+      case Op::le: Apply(out, a, b, n, Truth(std::less_equal<float>{}));
+	break;
+      case Op::gt: Apply(out, a, b, n, Truth(std::greater<float>{})); break;
+      case Op::ge: Apply(out, a, b, n, Truth(std::greater_equal<float>{}));
+	break;
+      case Op::eq: Apply(out, a, b, n, Truth(std::equal_to<float>{})); break;
+      case Op::ne: Apply(out, a, b, n, Truth(std::not_equal_to<float>{}));
+	break;
+      case Op::and_:
+	Apply(out, a, b, n, Truth([](float x, float y) {
+				return (x != 0.0f) & (y != 0.0f);
+			      }));
+	break;
+      case Op::or_:
+	Apply(out, a, b, n, Truth([](float x, float y) {
+				return (x != 0.0f) | (y != 0.0f);
+			      }));
+	break;
+      default:
+	break;
+    }
+    arg[top] = out;
+  }
+  return arg[0];
+} // eval
+
+std::vector<NutHit> SelectRows(const NutTable& table, const NutExpr* where,
+			       const NutExpr* by, std::size_t k,
+			       bool ascending)
+{
+  // better(a, b): a is listed before b.
+  auto better = [ascending](const NutHit& a, const NutHit& b) {
+    if (a.value != b.value)
+      return ascending ? a.value < b.value : a.value > b.value;
+    return a.row < b.row;
+  };
+  std::vector<NutHit> hits;  // with k, a heap with the worst in front
+  std::vector<float> where_scratch, by_scratch;
+  const auto rows = table.size();
+  for (gsl::index first = 0; first < rows; first += NutExpr::Block) {
+    const auto n = std::min<std::size_t>(NutExpr::Block, rows - first);
+    const float* keep = where ? where->eval(table, first, n, where_scratch)
+			      : nullptr;
+    const float* value = by ? by->eval(table, first, n, by_scratch)
+			    : nullptr;
+    for (std::size_t i = 0; i != n; ++i) {
+      if (keep && keep[i] == 0.0f)
+	continue;
+      const auto hit = NutHit{first + gsl::index(i), value ? value[i] : 0.0f};
+      if (!by) {
+	hits.push_back(hit);
+	if (hits.size() == k)
+	  return hits;
+	continue;
+      }
+      if (std::isnan(hit.value))
+	continue;
+      if (k == 0 || hits.size() < k) {
+	hits.push_back(hit);
+	if (k != 0)
+	  rng::push_heap(hits, better);
+      }
+      else if (better(hit, hits.front())) {
+	rng::pop_heap(hits, better);
+	hits.back() = hit;
+	rng::push_heap(hits, better);
+      }
+    }
+  }
+  if (by) {
+    if (k != 0)
+      rng::sort_heap(hits, better);
+    else
+      rng::sort(hits, better);
+  }
+  return hits;
+} // SelectRows
@@ -0,0 +1,97 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef NUT_QUERY_H
+#define NUT_QUERY_H
+#pragma once
+
+#include "IngredDb.h"
+
+#include <gsl/gsl>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// The Nutrition fields, in their order there, as query columns.
+enum class NutField : std::uint8_t {
+  g, ml, kcal, prot, fat, carb, fiber, alcohol, end
+};
+
+constexpr std::string_view NutFieldNames[] = {
+  "g", "ml", "kcal", "prot", "fat", "carb", "fiber", "alcohol"
+};
+
+constexpr std::optional<NutField> ParseField(std::string_view name) {
+  if (name == "protein")
+    return NutField::prot;
+  for (std::size_t i = 0; i != std::size(NutFieldNames); ++i) {
+    if (NutFieldNames[i] == name)
+      return NutField(i);
+  }
+  return std::nullopt;
+} // ParseField
+
+// A columnar copy of an IngredDb's Nutrition records, one float column
+// per field.  g is the record's weight, whether or not it is "each".
+class NutTable {
+  std::array<std::vector<float>, std::size_t(NutField::end)> cols;
+public:
+  explicit NutTable(const IngredDb& db);
+  gsl::index size() const { return cols[0].size(); }
+  const float* column(NutField f) const
+    { return cols[std::size_t(f)].data(); }
+}; // NutTable
+
+// An arithmetic and logical expression over the fields of a NutTable,
+// such as "fiber/carb > 0.3 and kcal/g < 1.5".  Numbers, field names,
+// + - * /, comparisons (< <= > >= == !=), and/or/not (or && || !) and
+// parentheses, with the usual precedence.  True is 1 and false 0; a
+// comparison with NaN (as from 0/0), other than !=, is false.
+//
+// It is compiled to postfix code and evaluated a block of rows at a
+// time, each operation a simple loop over a block, which the compiler
+// vectorizes.
+class NutExpr {
+public:
+  static constexpr std::size_t Block = 1024;  // rows per evaluation
+  enum class Op : std::uint8_t {
+    field, number, neg, not_, add, sub, mul, div,
+    lt, le, gt, ge, eq, ne, and_, or_
+  };
+  struct Code {
+    Op op = Op::number;
+    NutField field = NutField::g;
+    float number = 0.0f;
+  }; // Code
+private:
+  std::string _text;
+  std::vector<Code> code;  // postfix
+  int depth = 0;           // of the evaluation stack
+  class Parser;
+public:
+  // Throws std::runtime_error, naming the offset, on a syntax error.
+  explicit NutExpr(std::string_view text);
+  const std::string& text() const { return _text; }
+  // Evaluates rows [first, first+n) of table, n <= Block, using scratch.
+  // The result is valid until scratch is next used.
+  const float* eval(const NutTable& table, gsl::index first, std::size_t n,
+		    std::vector<float>& scratch) const;
+}; // NutExpr
+
+struct NutHit {
+  gsl::index row = 0;
+  float value = 0.0f;  // of the ranking expression
+}; // NutHit
+
+// The rows for which where (if any) is true, at most k of them (all, if
+// k is 0): if by is given, those with the greatest values of by (or the
+// least, if ascending), in that order, skipping NaN values; otherwise the
+// first in table order.  Ties go in table order.
+std::vector<NutHit> SelectRows(const NutTable& table, const NutExpr* where,
+			       const NutExpr* by, std::size_t k,
+			       bool ascending = false);
+
+#endif
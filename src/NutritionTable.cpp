@@ -0,0 +1,105 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "NutritionTable.h"
+
+#include "PerfectHash.h"
+
+#include <ranges>
+#include <algorithm>
+#include <cstring>
+
+namespace rng = std::ranges;
+
+namespace {
+
+constexpr std::uint64_t Seed = 0x6e7574726974696fu;
+
+} // local
+
+// The slot holding name, or the empty slot where it belongs.
+std::size_t NutritionTable::slot(std::string_view name,
+				 std::uint64_t hash) const
+{
+  for (auto i = hash & mask(); ; i = (i + 1) & mask()) {
+    if (slots[i] == 0)
+      return i;
+    const auto& e = entries[slots[i] - 1];
+    if (e.hash == hash && e.name == name)
+      return i;
+  }
+} // slot
+
+std::string_view NutritionTable::copy(std::string_view name) {
+  if (name.size() > left) {
+    auto size = std::max(BlockSize, name.size());
+    blocks.push_back(std::make_unique<char[]>(size));
+    next = blocks.back().get();
+    left = size;
+  }
+  if (!name.empty())
+    std::memcpy(next, name.data(), name.size());
+  auto rval = std::string_view{next, name.size()};
+  next += name.size();
+  left -= name.size();
+  return rval;
+} // copy
+
+void NutritionTable::grow() {
+  slots.assign(slots.size() * 2, 0);
+  for (std::uint32_t n = 0; n != entries.size(); ++n) {
+    auto i = entries[n].hash & mask();
+    while (slots[i] != 0)
+      i = (i + 1) & mask();
+    slots[i] = n + 1;
+  }
+} // grow
+
+NutritionTable::Entry* NutritionTable::find(std::string_view name) {
+  auto i = slot(name, PerfectHash::Hash(name, Seed));
+  return (slots[i] == 0) ? nullptr : &entries[slots[i] - 1];
+} // find
+
+const NutritionTable::Entry*
+NutritionTable::find(std::string_view name) const
+{
+  auto i = slot(name, PerfectHash::Hash(name, Seed));
+  return (slots[i] == 0) ? nullptr : &entries[slots[i] - 1];
+} // find
+
+std::pair<NutritionTable::Entry*, bool>
+NutritionTable::try_emplace(std::string_view name, const Nutrition& nutr)
+{
+  const auto hash = PerfectHash::Hash(name, Seed);
+  auto i = slot(name, hash);
+  if (slots[i] != 0)
+    return { &entries[slots[i] - 1], false };
+  entries.push_back(Entry{copy(name), nutr, hash});
+  slots[i] = std::uint32_t(entries.size());
+  if (2 * entries.size() > slots.size())
+    grow();
+  return { &entries.back(), true };
+} // try_emplace
+
+void NutritionTable::pop_back() {
+  const auto& e = entries.back();
+  auto i = slot(e.name, e.hash);
+  // Backward-shift deletion: move up any later entry of the cluster
+  // whose home slot is not between the hole and itself.
+  for (auto j = (i + 1) & mask(); slots[j] != 0; j = (j + 1) & mask()) {
+    auto home = entries[slots[j] - 1].hash & mask();
+    if (((j - home) & mask()) >= ((j - i) & mask())) {
+      slots[i] = slots[j];
+      i = j;
+    }
+  }
+  slots[i] = 0;
+  entries.pop_back();
+} // pop_back
+
+std::vector<const NutritionTable::Entry*> NutritionTable::sorted() const {
+  std::vector<const Entry*> rval;
+  rval.reserve(entries.size());
+  for (const auto& e: entries)
+    rval.push_back(&e);
+  rng::sort(rval, {}, &Entry::name);
+  return rval;
+} // sorted
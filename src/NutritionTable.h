@@ -0,0 +1,63 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef NUTRITIONTABLE_H
+#define NUTRITIONTABLE_H
+#pragma once
+
+#include "Nutrition.h"
+
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// Ingredient name --> Nutrition for digest.  Entries are kept in the order
+// they were added, with their names copied into an arena, and found by an
+// open-addressing (linear probing) table of entry numbers.  Sort once, with
+// sorted(), when the entries are written out.
+class NutritionTable {
+public:
+  struct Entry {
+    std::string_view name;  // in the arena
+    Nutrition nutr;
+    std::uint64_t hash = 0;
+  }; // Entry
+
+private:
+  static constexpr std::size_t BlockSize = 64 * 1024;
+  std::vector<Entry> entries;
+  std::vector<std::uint32_t> slots;  // entry + 1, or 0
+  std::vector<std::unique_ptr<char[]>> blocks;
+  char* next = nullptr;
+  std::size_t left = 0;
+
+  std::size_t mask() const { return slots.size() - 1; }
+  std::size_t slot(std::string_view name, std::uint64_t hash) const;
+  std::string_view copy(std::string_view name);
+  void grow();
+
+public:
+  NutritionTable() : slots(1024, 0) { }
+
+  std::size_t size() const { return entries.size(); }
+  bool empty() const { return entries.empty(); }
+  auto begin() const { return entries.begin(); }
+  auto end()   const { return entries.end(); }
+
+  Entry* find(std::string_view name);
+  const Entry* find(std::string_view name) const;
+  bool contains(std::string_view name) const { return (find(name) != nullptr); }
+
+  // The entry for name, and true if it was added with nutr.  Entry pointers
+  // are good until the next entry is added.
+  std::pair<Entry*, bool> try_emplace(std::string_view name,
+				      const Nutrition& nutr);
+  // Removes the entry added last.
+  void pop_back();
+
+  // All entries, by name.
+  std::vector<const Entry*> sorted() const;
+}; // NutritionTable
+
+#endif
@@ -0,0 +1,163 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "PerfectHash.h"
+
+#include <ranges>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <cstring>
+
+namespace rng = std::ranges;
+
+namespace {
+
+constexpr std::uint64_t Golden = 0x9e3779b97f4a7c15;
+constexpr std::uint32_t Direct = 0x80000000;
+constexpr std::uint32_t MaxDisp = 1 << 20;
+constexpr int MaxAttempts = 32;
+
+constexpr std::uint64_t Mix(std::uint64_t x) {
+  x ^= x >> 32;
+  x *= 0xd6e8feb86659fd93;
+  x ^= x >> 32;
+  x *= 0xd6e8feb86659fd93;
+  x ^= x >> 32;
+  return x;
+} // Mix
+
+constexpr std::uint32_t Bucket(std::uint64_t h, std::uint32_t buckets)
+{ return (h >> 32) % buckets; }
+
+constexpr std::uint32_t Slot(std::uint64_t h, std::uint32_t d,
+			     std::uint32_t slots)
+{ return Mix(h ^ ((d + 1) * Golden)) % slots; }
+
+} // local
+
+std::uint64_t PerfectHash::Hash(std::string_view key, std::uint64_t seed) {
+  auto h = seed ^ (key.size() * Golden);
+  auto p = key.data();
+  auto n = key.size();
+  for (; n >= 8; p += 8, n -= 8) {
+    std::uint64_t w;
+    std::memcpy(&w, p, 8);
+    h = Mix(h ^ w) + Golden;
+  }
+  std::uint64_t w = 0;
+  std::memcpy(&w, p, n);
+  return Mix(h ^ w ^ (std::uint64_t{n} << 56));
+} // Hash
+
+PerfectHash::PerfectHash(std::string_view blob) {
+  if (blob.empty())
+    return;
+  if (blob.size() < sizeof(Header))
+    throw std::runtime_error{"PerfectHash: truncated table"};
+  hdr = reinterpret_cast<const Header*>(blob.data());
+  const auto need = sizeof(Header)
+	  + (std::size_t{hdr->buckets} + hdr->slots) * sizeof(std::uint32_t);
+  if (blob.size() != need || (hdr->slots != 0 && hdr->buckets == 0))
+    throw std::runtime_error{"PerfectHash: corrupt table"};
+  disp  = reinterpret_cast<const std::uint32_t*>(blob.data() + sizeof(Header));
+  index = disp + hdr->buckets;
+  for (std::uint32_t b = 0; b != hdr->buckets; ++b) {
+    if ((disp[b] & Direct) && (disp[b] & ~Direct) >= hdr->slots)
+      throw std::runtime_error{"PerfectHash: corrupt table"};
+  }
+} // ctor
+
+gsl::index PerfectHash::operator()(std::string_view key) const {
+  if (empty())
+    return -1;
+  const auto h = Hash(key, hdr->seed);
+  const auto d = disp[Bucket(h, hdr->buckets)];
+  const auto slot = (d & Direct) ? (d & ~Direct) : Slot(h, d, hdr->slots);
+  return index[slot];
+} // operator()
+
+std::string PerfectHash::Build(const std::vector<std::string_view>& keys) {
+  Header hdr;
+  const auto n = gsl::narrow<std::uint32_t>(keys.size());
+  if (n == 0)
+    return std::string(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+  hdr.slots   = n;
+  hdr.buckets = n / 3 + 1;
+
+  std::vector<std::uint64_t> hashes(n);
+  std::vector<std::vector<std::uint32_t>> buckets(hdr.buckets);
+  std::vector<std::uint32_t> order(hdr.buckets);
+  std::vector<std::uint32_t> disp(hdr.buckets);
+  std::vector<std::uint32_t> index(n);
+  std::vector<bool> taken(n);
+  std::vector<std::uint32_t> slots;
+
+  for (int attempt = 0; attempt != MaxAttempts; ++attempt) {
+    hdr.seed = Mix(attempt * Golden + n);
+    for (auto& b: buckets)
+      b.clear();
+    for (std::uint32_t i = 0; i != n; ++i) {
+      hashes[i] = Hash(keys[i], hdr.seed);
+      buckets[Bucket(hashes[i], hdr.buckets)].push_back(i);
+    }
+    std::iota(order.begin(), order.end(), 0);
+    rng::stable_sort(order, rng::greater{},
+		     [&buckets](std::uint32_t b) { return buckets[b].size(); });
+    rng::fill(disp, 0);
+    taken.assign(n, false);
+
+    bool ok = true;
+    std::uint32_t next_free = 0;
+    for (auto b: order) {
+      const auto& bucket = buckets[b];
+      if (bucket.empty())
+	break;
+      if (bucket.size() == 1) {
+	while (taken[next_free])
+	  ++next_free;
+	disp[b] = Direct | next_free;
+	taken[next_free] = true;
+	index[next_free] = bucket.front();
+	continue;
+      }
+      std::uint32_t d = 0;
+      for (; d != MaxDisp; ++d) {
+	slots.clear();
+	for (auto i: bucket) {
+	  auto s = Slot(hashes[i], d, n);
+	  if (taken[s] || rng::find(slots, s) != slots.end())
+	    break;
+	  slots.push_back(s);
+	}
+	if (slots.size() == bucket.size())
+	  break;
+      }
+      if (d == MaxDisp) {
+	for (auto i: bucket) {
+	  for (auto j: bucket) {
+	    if (i < j && keys[i] == keys[j])
+	      throw std::logic_error{"PerfectHash: duplicate key"};
+	  }
+	}
+	ok = false;
+	break;
+      }
+      disp[b] = d;
+      for (std::size_t k = 0; k != bucket.size(); ++k) {
+	taken[slots[k]] = true;
+	index[slots[k]] = bucket[k];
+      }
+    }
+    if (!ok)
+      continue;
+
+    std::string blob;
+    blob.reserve(sizeof(hdr) + (disp.size() + index.size()) * sizeof(n));
+    blob.append(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    blob.append(reinterpret_cast<const char*>(disp.data()),
+		disp.size() * sizeof(disp[0]));
+    blob.append(reinterpret_cast<const char*>(index.data()),
+		index.size() * sizeof(index[0]));
+    return blob;
+  }
+  throw std::runtime_error{"PerfectHash: cannot build table"};
+} // Build
@@ -0,0 +1,42 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef PERFECT_HASH_H
+#define PERFECT_HASH_H
+#pragma once
+
+#include <gsl/gsl>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// Minimal perfect hash over a fixed set of strings (hash and displace, as
+// in CHD).  Keys are split into buckets by one hash; each bucket stores a
+// displacement that moves all of its keys into free slots, so a lookup
+// costs one string hash and one probe.  Single-key buckets store their
+// slot directly.  The serialized form is position independent and is used
+// in place from a mapped file.
+class PerfectHash {
+public:
+  struct Header {
+    std::uint64_t seed    = 0;
+    std::uint32_t buckets = 0;
+    std::uint32_t slots   = 0;
+  }; // Header
+private:
+  const Header* hdr = nullptr;
+  const std::uint32_t* disp = nullptr;
+  const std::uint32_t* index = nullptr;
+public:
+  static std::uint64_t Hash(std::string_view key, std::uint64_t seed);
+  // Builds the table for keys, which must be unique.  Key i hashes to i.
+  static std::string Build(const std::vector<std::string_view>& keys);
+  PerfectHash() = default;
+  explicit PerfectHash(std::string_view blob);
+  bool empty() const { return (!hdr || hdr->slots == 0); }
+  // Returns the only index that key can have, or -1 if the table is empty.
+  // Unknown keys also return an index; the caller must compare.
+  gsl::index operator()(std::string_view key) const;
+}; // PerfectHash
+
+#endif
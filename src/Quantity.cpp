@@ -0,0 +1,158 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "Quantity.h"
+
+#include "To.h"  // from_chars(double) where the library lacks it
+
+#include <charconv>
+#include <cstdint>
+#include <cmath>
+
+namespace {
+
+struct Vulgar {
+  std::uint8_t num;
+  std::uint8_t den;
+}; // Vulgar
+
+// U+00BC..U+00BE, UTF-8 C2 BC..BE.
+constexpr Vulgar Latin1[] = { {1, 4}, {1, 2}, {3, 4} };
+
+// U+2150..U+215E, UTF-8 E2 85 90..9E.
+constexpr Vulgar NumberForms[] = {
+  {1, 7}, {1, 9}, {1, 10}, {1, 3}, {2, 3}, {1, 5}, {2, 5}, {3, 5},
+  {4, 5}, {1, 6}, {5, 6}, {1, 8}, {3, 8}, {5, 8}, {7, 8}
+}; // NumberForms
+
+// Decodes a vulgar fraction at the front of str, returning its length in
+// bytes (0 if there is none).
+std::size_t DecodeVulgar(std::string_view str, double& value) {
+  auto byte = [str](std::size_t i) { return std::uint8_t(str[i]); };
+  const Vulgar* v = nullptr;
+  std::size_t len = 0;
+  if (str.size() >= 2 && byte(0) == 0xC2
+      && byte(1) >= 0xBC && byte(1) <= 0xBE)
+  {
+    v = &Latin1[byte(1) - 0xBC];
+    len = 2;
+  }
+  else if (str.size() >= 3 && byte(0) == 0xE2 && byte(1) == 0x85
+	   && byte(2) >= 0x90 && byte(2) <= 0x9E)
+  {
+    v = &NumberForms[byte(2) - 0x90];
+    len = 3;
+  }
+  if (v)
+    value = double(v->num) / v->den;
+  return len;
+} // DecodeVulgar
+
+constexpr bool IsDigit(char c) { return (c >= '0' && c <= '9'); }
+
+constexpr bool IsSpace(char c)
+{ return (c == ' ' || (c >= '\t' && c <= '\r')); }
+
+void SkipSpace(std::string_view& str) {
+  while (!str.empty() && IsSpace(str.front()))
+    str.remove_prefix(1);
+} // SkipSpace
+
+std::size_t CountDigits(std::string_view str) {
+  std::size_t n = 0;
+  while (n != str.size() && IsDigit(str[n]))
+    ++n;
+  return n;
+} // CountDigits
+
+// Parses a whole number of at most 9 digits from the front of str.
+bool ParseInt(std::string_view& str, std::uint32_t& n) {
+  const auto len = CountDigits(str);
+  if (len == 0 || len > 9)
+    return false;
+  std::from_chars(str.data(), str.data() + len, n);
+  str.remove_prefix(len);
+  return true;
+} // ParseInt
+
+// A proper fraction: "n/d" (or "n/ d") or a vulgar fraction character.
+bool ParseFraction(std::string_view& str, double& value) {
+  if (auto len = DecodeVulgar(str, value)) {
+    str.remove_prefix(len);
+    return true;
+  }
+  std::uint32_t num = 0;
+  std::uint32_t den = 0;
+  auto s = str;
+  if (!ParseInt(s, num) || !s.starts_with('/'))
+    return false;
+  s.remove_prefix(1);
+  SkipSpace(s);
+  if (!ParseInt(s, den) || den <= num)
+    return false;
+  value = double(num) / den;
+  str = s;
+  return true;
+} // ParseFraction
+
+// One end of a range: a decimal, a fraction, or a mixed number.
+bool ParseTerm(std::string_view& str, double& value) {
+  if (ParseFraction(str, value))
+    return true;
+  auto len = CountDigits(str);
+  const bool whole = (len == str.size() || str[len] != '.');
+  if (!whole)
+    len += 1 + CountDigits(str.substr(len + 1));
+  if (len == 0 || str.substr(0, len) == ".")
+    return false;
+  auto [ptr, ec] = std::from_chars(str.data(), str.data() + len, value);
+  if (ec != std::errc{} || ptr != str.data() + len || !std::isfinite(value))
+    return false;
+  str.remove_prefix(len);
+  if (!whole || str.empty())
+    return true;
+
+  // Whole number: an adjoining vulgar fraction, or whitespace or '-' (and
+  // any whitespace) and then a fraction, make it a mixed number.
+  double frac = 0.0;
+  if (auto n = DecodeVulgar(str, frac)) {
+    str.remove_prefix(n);
+    value += frac;
+    return true;
+  }
+  auto s = str;
+  if (s.front() == '-')
+    s.remove_prefix(1);
+  SkipSpace(s);
+  if (s.size() != str.size() && ParseFraction(s, frac) && frac > 0.0) {
+    value += frac;
+    str = s;
+  }
+  return true;
+} // ParseTerm
+
+} // local
+
+std::optional<double> ParseQuantity(std::string_view str) {
+  SkipSpace(str);
+  while (!str.empty() && IsSpace(str.back()))
+    str.remove_suffix(1);
+  double lo = 0.0;
+  if (!ParseTerm(str, lo))
+    return std::nullopt;
+  if (str.empty())
+    return lo;
+  if (str.front() != '-')
+    return std::nullopt;
+  str.remove_prefix(1);
+  double hi = 0.0;
+  if (!ParseTerm(str, hi) || !str.empty() || !(lo < hi))
+    return std::nullopt;
+  return (lo + hi) / 2;
+} // ParseQuantity
+
+std::optional<double> VulgarFraction(std::string_view str) {
+  double value = 0.0;
+  auto len = DecodeVulgar(str, value);
+  if (len == 0 || len != str.size())
+    return std::nullopt;
+  return value;
+} // VulgarFraction
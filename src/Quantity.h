@@ -0,0 +1,23 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef QUANTITY_H
+#define QUANTITY_H
+#pragma once
+
+#include <string_view>
+#include <optional>
+
+// Recipe quantities, as written in the value field of a recipe line:
+//
+//   3   2.5   .75   1/2   ½   1½   1 1/2   1-1/2   1 ½   2-3   1/2-1
+//
+// Fractions must be proper (1/2, not 3/2).  A whole number followed by
+// whitespace or '-' and a fraction is a mixed number; otherwise "a-b" is
+// a range, whose value is its midpoint.  Signs and exponents are not
+// quantities.  Returns nullopt if str is not a quantity.
+std::optional<double> ParseQuantity(std::string_view str);
+
+// If str is exactly one Unicode vulgar fraction character (UTF-8),
+// returns its value.
+std::optional<double> VulgarFraction(std::string_view str);
+
+#endif
@@ -0,0 +1,26 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef REPORT_FORMAT_H
+#define REPORT_FORMAT_H
+#pragma once
+
+#include <string_view>
+#include <optional>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+
+// The forms of nut's report, as named by --format=, and as sent in the
+// first byte of a nut --serve request.
+enum class ReportFormat : std::uint8_t { human, tsv, json, end };
+
+constexpr std::string_view ReportFormatNames[] = { "human", "tsv", "json" };
+
+constexpr std::optional<ReportFormat> ParseFormat(std::string_view name) {
+  for (std::size_t i = 0; i != std::size(ReportFormatNames); ++i) {
+    if (ReportFormatNames[i] == name)
+      return ReportFormat(i);
+  }
+  return std::nullopt;
+} // ParseFormat
+
+#endif
@@ -0,0 +1,147 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "Socket.h"
+
+#include <system_error>
+#include <stdexcept>
+#include <utility>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+[[noreturn]] void ThrowErrno(const std::string& what)
+{ throw std::system_error{errno, std::generic_category(), what}; }
+
+sockaddr_un Address(const std::string& path) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(addr.sun_path))
+    throw std::runtime_error{path + ": bad socket path"};
+  std::memcpy(addr.sun_path, path.data(), path.size());
+  return addr;
+} // Address
+
+int NewSocket(const std::string& path) {
+  int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    ThrowErrno(path + ": cannot create socket");
+  return fd;
+} // NewSocket
+
+// Reads exactly size bytes; false if the stream ends first.
+bool ReadAll(int fd, char* data, std::size_t size) {
+  while (size != 0) {
+    auto n = ::recv(fd, data, size, 0);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      ThrowErrno("socket read");
+    if (n == 0)
+      return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+} // ReadAll
+
+void WriteAll(int fd, const char* data, std::size_t size) {
+  while (size != 0) {
+    auto n = ::send(fd, data, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      ThrowErrno("socket write");
+    data += n;
+    size -= n;
+  }
+} // WriteAll
+
+} // local
+
+std::string UnixSocket::DefaultPath() {
+  if (auto path = std::getenv("NUT_SOCKET"))
+    return path;
+  if (auto dir = std::getenv("INGRED_PATH"))
+    return dir + std::string{"/nut.sock"};
+  throw std::runtime_error{"neither NUT_SOCKET nor INGRED_PATH is set"};
+} // DefaultPath
+
+UnixSocket UnixSocket::Listen(const std::string& path) {
+  auto addr = Address(path);
+  auto sock = UnixSocket{NewSocket(path)};
+  struct stat st;
+  if (::lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+    // Replace the socket only if nothing answers there.
+    auto probe = UnixSocket{NewSocket(path)};
+    if (::connect(probe.fd, reinterpret_cast<const sockaddr*>(&addr),
+		  sizeof(addr)) == 0)
+      throw std::runtime_error{path + ": already serving"};
+    if (errno != ECONNREFUSED)
+      ThrowErrno(path + ": cannot probe");
+    ::unlink(path.c_str());
+  }
+  if (::bind(sock.fd, reinterpret_cast<const sockaddr*>(&addr),
+	     sizeof(addr)) != 0)
+    ThrowErrno(path + ": cannot bind");
+  if (::listen(sock.fd, SOMAXCONN) != 0)
+    ThrowErrno(path + ": cannot listen");
+  return sock;
+} // Listen
+
+UnixSocket UnixSocket::Connect(const std::string& path) {
+  auto addr = Address(path);
+  auto sock = UnixSocket{NewSocket(path)};
+  if (::connect(sock.fd, reinterpret_cast<const sockaddr*>(&addr),
+		sizeof(addr)) != 0)
+    ThrowErrno(path + ": cannot connect");
+  return sock;
+} // Connect
+
+UnixSocket& UnixSocket::operator=(UnixSocket&& rhs) noexcept {
+  if (this != &rhs) {
+    UnixSocket tmp{std::move(*this)};
+    fd = std::exchange(rhs.fd, -1);
+  }
+  return *this;
+} // move assignment
+
+UnixSocket::~UnixSocket() {
+  if (fd >= 0)
+    ::close(fd);
+} // dtor
+
+UnixSocket UnixSocket::accept() const {
+  for (;;) {
+    int conn = ::accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (conn >= 0)
+      return UnixSocket{conn};
+    if (errno != EINTR && errno != ECONNABORTED)
+      ThrowErrno("socket accept");
+  }
+} // accept
+
+bool UnixSocket::read(std::string& frame) const {
+  std::uint32_t size = 0;
+  if (!ReadAll(fd, reinterpret_cast<char*>(&size), sizeof(size)))
+    return false;
+  if (size > MaxFrame)
+    throw std::runtime_error{"socket read: frame too large"};
+  frame.resize(size);
+  if (!ReadAll(fd, frame.data(), size))
+    throw std::runtime_error{"socket read: truncated frame"};
+  return true;
+} // read
+
+void UnixSocket::write(std::string_view frame) const {
+  if (frame.size() > MaxFrame)
+    throw std::runtime_error{"socket write: frame too large"};
+  const auto size = std::uint32_t(frame.size());
+  WriteAll(fd, reinterpret_cast<const char*>(&size), sizeof(size));
+  WriteAll(fd, frame.data(), frame.size());
+} // write
@@ -0,0 +1,48 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef SOCKET_H
+#define SOCKET_H
+#pragma once
+
+#include "ReportFormat.h"
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// Unix domain stream sockets carrying framed messages, for nut --serve
+// and its client.  Each frame is a uint32 length, in native byte order,
+// followed by that many bytes.
+//
+// A request is one frame: a ReportFormat byte and then recipe text,
+// exactly as nut reads it from stdin.  The reply is one frame: a Status
+// byte and then the report nut would have written to stdout, including
+// any error message.
+
+class UnixSocket {
+  int fd = -1;
+  explicit UnixSocket(int fd_) : fd{fd_} { }
+public:
+  enum class Status : std::uint8_t { ok, error };
+  static constexpr std::uint32_t MaxFrame = 64 << 20;
+
+  // $NUT_SOCKET, or nut.sock in $INGRED_PATH.
+  static std::string DefaultPath();
+  // Binds and listens at path, replacing a stale socket there; throws if
+  // a server already answers there.
+  static UnixSocket Listen(const std::string& path);
+  static UnixSocket Connect(const std::string& path);
+
+  UnixSocket() = default;
+  UnixSocket(UnixSocket&& rhs) noexcept : fd{rhs.fd} { rhs.fd = -1; }
+  UnixSocket& operator=(UnixSocket&& rhs) noexcept;
+  UnixSocket(const UnixSocket&) = delete;
+  UnixSocket& operator=(const UnixSocket&) = delete;
+  ~UnixSocket();
+
+  UnixSocket accept() const;
+  // False at end of stream, before any of a frame.
+  bool read(std::string& frame) const;
+  void write(std::string_view frame) const;
+}; // UnixSocket
+
+#endif
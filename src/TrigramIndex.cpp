@@ -0,0 +1,141 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "TrigramIndex.h"
+
+#include <ranges>
+#include <algorithm>
+#include <span>
+#include <utility>
+#include <stdexcept>
+#include <cstdlib>
+
+namespace rng = std::ranges;
+
+std::vector<std::uint32_t> TrigramIndex::Trigrams(std::string_view key) {
+  auto at = [key](std::size_t i) -> std::uint32_t {  // padded key[i-2]
+    return (i < 2 || i - 2 >= key.size())
+	? 0 : static_cast<unsigned char>(key[i - 2]);
+  };
+  std::vector<std::uint32_t> grams;
+  grams.reserve(key.size() + 2);
+  for (std::size_t i = 0; i != key.size() + 2; ++i)
+    grams.push_back((at(i) << 16) | (at(i + 1) << 8) | at(i + 2));
+  rng::sort(grams);
+  grams.erase(rng::unique(grams).begin(), grams.end());
+  return grams;
+} // Trigrams
+
+std::string TrigramIndex::Build(const std::vector<std::string_view>& keys) {
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;  // gram, key
+  for (std::uint32_t i = 0; i != keys.size(); ++i) {
+    for (auto gram: Trigrams(keys[i]))
+      pairs.emplace_back(gram, i);
+  }
+  rng::sort(pairs);
+
+  std::vector<Gram> table;
+  std::vector<std::uint32_t> posts;
+  posts.reserve(pairs.size());
+  for (const auto& [gram, key]: pairs) {
+    if (table.empty() || table.back().gram != gram)
+      table.push_back(Gram{gram, gsl::narrow<std::uint32_t>(posts.size())});
+    posts.push_back(key);
+  }
+  Header hdr;
+  hdr.keys  = gsl::narrow<std::uint32_t>(keys.size());
+  hdr.grams = gsl::narrow<std::uint32_t>(table.size());
+  table.push_back(Gram{0, gsl::narrow<std::uint32_t>(posts.size())});
+
+  std::string blob;
+  blob.append(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+  blob.append(reinterpret_cast<const char*>(table.data()),
+	      table.size() * sizeof(table[0]));
+  blob.append(reinterpret_cast<const char*>(posts.data()),
+	      posts.size() * sizeof(posts[0]));
+  return blob;
+} // Build
+
+TrigramIndex::TrigramIndex(std::string_view blob) {
+  if (blob.empty())
+    return;
+  if (blob.size() < sizeof(Header))
+    throw std::runtime_error{"TrigramIndex: truncated index"};
+  hdr = reinterpret_cast<const Header*>(blob.data());
+  const auto table = sizeof(Header) + (hdr->grams + std::size_t{1})
+						* sizeof(Gram);
+  if (blob.size() < table)
+    throw std::runtime_error{"TrigramIndex: truncated index"};
+  grams = reinterpret_cast<const Gram*>(blob.data() + sizeof(Header));
+  postings = reinterpret_cast<const std::uint32_t*>(blob.data() + table);
+  const auto n = grams[hdr->grams].posting;
+  if (blob.size() != table + std::size_t{n} * sizeof(std::uint32_t))
+    throw std::runtime_error{"TrigramIndex: corrupt index"};
+  for (std::uint32_t g = 0; g != hdr->grams; ++g) {
+    if (grams[g].posting > grams[g+1].posting)
+      throw std::runtime_error{"TrigramIndex: corrupt index"};
+  }
+  for (std::uint32_t p = 0; p != n; ++p) {
+    if (postings[p] >= hdr->keys)
+      throw std::runtime_error{"TrigramIndex: corrupt index"};
+  }
+} // ctor
+
+std::vector<gsl::index> TrigramIndex::candidates(std::string_view key,
+						 int min_shared) const
+{
+  std::vector<gsl::index> found;
+  if (empty())
+    return found;
+  const auto table = std::span{grams, hdr->grams};
+  std::vector<std::uint8_t> shared(hdr->keys);
+  std::vector<std::uint32_t> touched;
+  for (auto gram: Trigrams(key)) {
+    auto g = rng::lower_bound(table, gram, {}, &Gram::gram);
+    if (g == table.end() || g->gram != gram)
+      continue;
+    for (auto p = g->posting; p != (g+1)->posting; ++p) {
+      auto& n = shared[postings[p]];
+      if (n == 0)
+	touched.push_back(postings[p]);
+      if (n != 0xff)
+	++n;
+    }
+  }
+  rng::sort(touched);
+  for (auto i: touched) {
+    if (shared[i] >= min_shared)
+      found.push_back(i);
+  }
+  return found;
+} // candidates
+
+int BoundedEditDistance(std::string_view a, std::string_view b, int max) {
+  const int m = a.size();
+  const int n = b.size();
+  if (std::abs(m - n) > max)
+    return max + 1;
+  const int far = max + 1;  // any distance over max
+  std::vector<int> prev(n + 1), cur(n + 1);
+  for (int j = 0; j <= n; ++j)
+    prev[j] = std::min(j, far);
+  for (int i = 1; i <= m; ++i) {
+    const int lo = std::max(1, i - max);
+    const int hi = std::min(n, i + max);
+    cur[0] = std::min(i, far);
+    if (lo > 1)
+      cur[lo - 1] = far;
+    int best = cur[0];
+    for (int j = lo; j <= hi; ++j) {
+      const int sub = prev[j-1] + (a[i-1] != b[j-1]);
+      const int del = prev[j] + 1;
+      const int ins = cur[j-1] + 1;
+      cur[j] = std::min({sub, del, ins, far});
+      best = std::min(best, cur[j]);
+    }
+    if (hi < n)
+      cur[hi + 1] = far;
+    if (best > max)
+      return far;
+    std::swap(prev, cur);
+  }
+  return std::min(prev[n], far);
+} // BoundedEditDistance
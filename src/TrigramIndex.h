@@ -0,0 +1,53 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+#pragma once
+
+#include <gsl/gsl>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// Trigram index over a fixed set of strings, for finding those within a
+// small edit distance of a key.  Each string is padded with two NULs on
+// both sides, so a string of n characters has n+2 trigrams and one edit
+// changes at most three of them: a string within distance k of the key
+// shares at least (the key's distinct trigrams - 3k) of them.  The
+// serialized form is position independent and is used in place from a
+// mapped file.
+class TrigramIndex {
+public:
+  struct Header {
+    std::uint32_t keys  = 0;
+    std::uint32_t grams = 0;
+  }; // Header
+  struct Gram {
+    std::uint32_t gram    = 0;  // three bytes, the first in bits 16-23
+    std::uint32_t posting = 0;  // first; the next Gram's ends them
+  }; // Gram
+private:
+  const Header* hdr = nullptr;
+  const Gram* grams = nullptr;     // [grams+1], sorted
+  const std::uint32_t* postings = nullptr;  // key indexes, ascending
+public:
+  // The distinct trigrams of key, sorted.
+  static std::vector<std::uint32_t> Trigrams(std::string_view key);
+  // Builds the index for keys.  Key i is found as i.
+  static std::string Build(const std::vector<std::string_view>& keys);
+  TrigramIndex() = default;
+  explicit TrigramIndex(std::string_view blob);
+  bool empty() const { return (!hdr || hdr->keys == 0); }
+  gsl::index keys() const { return hdr ? hdr->keys : 0; }
+  // The keys that share at least min_shared distinct trigrams with key,
+  // in index order.
+  std::vector<gsl::index> candidates(std::string_view key,
+				     int min_shared) const;
+}; // TrigramIndex
+
+// The Levenshtein distance between a and b, or max+1 if it exceeds max.
+// Only the band of width 2*max+1 about the diagonal is computed.
+int BoundedEditDistance(std::string_view a, std::string_view b, int max);
+
+#endif
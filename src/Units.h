@@ -0,0 +1,228 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef UNITS_H
+#define UNITS_H
+#pragma once
+
+#include "FoldCase.h"
+
+#include <array>
+#include <algorithm>
+#include <string_view>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+// Units of measure shared by nut, lookup and tabulate.  Everything here is
+// constexpr: spellings are resolved by a perfect hash that is built, and
+// checked, at compile time.
+
+enum class Unit : std::uint8_t {
+  none, ea,
+  ml, l, tsp, tbsp, floz, shot, cup, pt, qt, gal, cuin,
+  g, kg, oz, lb,
+  end
+}; // Unit
+
+struct UnitDef {
+  std::string_view name;
+  double ml = 0.0;  // per unit, if a volume
+  double g  = 0.0;  // per unit, if a mass
+}; // UnitDef
+
+constexpr UnitDef UnitDefs[] = {
+  { ""                  },
+  { "ea"                },
+  { "ml",      1        },
+  { "l",    1000        },
+  { "tsp",     4.9289   },
+  { "tbsp",   14.7868   },
+  { "floz",   29.5735   },
+  { "shot",   44.3603   },
+  { "cup",   236.5882   },
+  { "pt",    473.1765   },
+  { "qt",    946.3529   },
+  { "gal",  3785.4118   },
+  { "cuin",   16.3871   },
+  { "g",       0,    1        },
+  { "kg",      0, 1000        },
+  { "oz",      0,   28.3495   },
+  { "lb",      0,  453.5924   }
+}; // UnitDefs
+
+static_assert(std::size(UnitDefs) == std::size_t(Unit::end));
+
+constexpr const UnitDef& UnitDefOf(Unit u) { return UnitDefs[std::size_t(u)]; }
+constexpr std::string_view UnitName(Unit u) { return UnitDefOf(u).name; }
+constexpr bool IsVolume(Unit u) { return (UnitDefOf(u).ml != 0.0); }
+constexpr bool IsMass(Unit u)   { return (UnitDefOf(u).g  != 0.0); }
+
+// Strongly typed amounts, so that millilitres and grams cannot be mixed.
+struct Volume {
+  double ml = 0.0;
+  constexpr Volume() = default;
+  constexpr Volume(double n, Unit u) : ml{n * UnitDefOf(u).ml} { }
+}; // Volume
+
+struct Mass {
+  double g = 0.0;
+  constexpr Mass() = default;
+  constexpr Mass(double n, Unit u) : g{n * UnitDefOf(u).g} { }
+}; // Mass
+
+struct UnitSpelling {
+  std::string_view text;  // lower case
+  Unit unit;
+  bool recipe = true;     // accepted by nut in a recipe line
+}; // UnitSpelling
+
+constexpr UnitSpelling UnitSpellings[] = {
+  { "ea",          Unit::ea   },
+  { "each",        Unit::ea   },
+  { "piece",       Unit::ea   },
+  { "pieces",      Unit::ea   },
+  { "ml",          Unit::ml   },
+  { "milliliter",  Unit::ml, false },
+  { "milliliters", Unit::ml, false },
+  { "cc",          Unit::ml, false },
+  { "cubic centimeter",  Unit::ml, false },
+  { "cubic centimeters", Unit::ml, false },
+  { "l",           Unit::l    },
+  { "liter",       Unit::l    },
+  { "liters",      Unit::l    },
+  { "t",           Unit::tsp  },
+  { "tsp",         Unit::tsp  },
+  { "tsps",        Unit::tsp  },
+  { "teaspoon",    Unit::tsp  },
+  { "teaspoons",   Unit::tsp  },
+  { "tbsp",        Unit::tbsp },
+  { "tbsps",       Unit::tbsp },
+  { "tablespoon",  Unit::tbsp },
+  { "tablespoons", Unit::tbsp },
+  { "floz",        Unit::floz },
+  { "fl oz",       Unit::floz, false },
+  { "shot",        Unit::shot },
+  { "shots",       Unit::shot },
+  { "c",           Unit::cup  },
+  { "cup",         Unit::cup  },
+  { "cups",        Unit::cup  },
+  { "pt",          Unit::pt   },
+  { "pint",        Unit::pt   },
+  { "pints",       Unit::pt   },
+  { "qt",          Unit::qt   },
+  { "quart",       Unit::qt   },
+  { "quarts",      Unit::qt   },
+  { "gal",         Unit::gal  },
+  { "gallon",      Unit::gal  },
+  { "gallons",     Unit::gal  },
+  { "cubic inch",  Unit::cuin, false },
+  { "cubic inches", Unit::cuin, false },
+  { "g",           Unit::g    },
+  { "gram",        Unit::g    },
+  { "grams",       Unit::g    },
+  { "kg",          Unit::kg   },
+  { "oz",          Unit::oz   },
+  { "ounce",       Unit::oz   },
+  { "ounces",      Unit::oz   },
+  { "lb",          Unit::lb   },
+  { "#",           Unit::lb   },
+  { "pound",       Unit::lb   },
+  { "pounds",      Unit::lb   }
+}; // UnitSpellings
+
+// FNV-1a over the case-folded text, then a final mix of the high bits.
+constexpr std::uint32_t UnitHash(std::string_view str, std::uint32_t seed) {
+  std::uint32_t h = 2166136261u ^ seed;
+  for (char c: str)
+    h = (h ^ std::uint8_t(FoldCase(c))) * 16777619u;
+  h ^= h >> 15;
+  h *= 0x2c1b3c6dU;
+  h ^= h >> 12;
+  return h;
+} // UnitHash
+
+struct UnitIndex {
+  static constexpr std::size_t Slots = 256;  // power of 2
+  std::uint32_t seed = 0;
+  std::array<std::uint8_t, Slots> slots{};   // spelling + 1, or 0
+  std::size_t longest = 0;
+}; // UnitIndex
+
+static_assert(std::size(UnitSpellings) < UnitIndex::Slots);
+
+constexpr UnitIndex MakeUnitIndex() {
+  UnitIndex index;
+  for (const auto& s: UnitSpellings)
+    index.longest = std::max(index.longest, s.text.size());
+  for (index.seed = 0; ; ++index.seed) {
+    index.slots = {};
+    bool ok = true;
+    for (std::size_t i = 0; ok && i != std::size(UnitSpellings); ++i) {
+      auto& slot = index.slots[UnitHash(UnitSpellings[i].text, index.seed)
+			       % UnitIndex::Slots];
+      ok = (slot == 0);
+      slot = std::uint8_t(i + 1);
+    }
+    if (ok)
+      return index;
+  }
+} // MakeUnitIndex
+
+inline constexpr UnitIndex UnitIndexTable = MakeUnitIndex();
+
+// Case-insensitive; nullptr if str is not a unit.
+constexpr const UnitSpelling* FindSpelling(std::string_view str) {
+  const auto& index = UnitIndexTable;
+  if (str.empty() || str.size() > index.longest)
+    return nullptr;
+  auto slot = index.slots[UnitHash(str, index.seed) % UnitIndex::Slots];
+  if (slot == 0)
+    return nullptr;
+  const auto& s = UnitSpellings[slot - 1];
+  if (s.text.size() != str.size())
+    return nullptr;
+  for (std::size_t i = 0; i != str.size(); ++i) {
+    if (FoldCase(str[i]) != s.text[i])
+      return nullptr;
+  }
+  return &s;
+} // FindSpelling
+
+// Case-insensitive; Unit::none if str is not a unit.
+constexpr Unit FindUnit(std::string_view str) {
+  const auto* s = FindSpelling(str);
+  return s ? s->unit : Unit::none;
+} // FindUnit
+
+// As FindUnit, but only the spellings nut has always accepted in recipes;
+// the USDA-only ones, such as "cc" and "cubic inch", are Unit::none.
+constexpr Unit FindRecipeUnit(std::string_view str) {
+  const auto* s = FindSpelling(str);
+  return (s && s->recipe) ? s->unit : Unit::none;
+} // FindRecipeUnit
+
+// The longest unit spelling that starts str and ends a word, with its
+// length, or { Unit::none, 0 }.
+constexpr std::pair<Unit, std::size_t> FindUnitPrefix(std::string_view str) {
+  auto is_word = [](char c) {
+    c = FoldCase(c);
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+  };
+  for (auto n = std::min(str.size(), UnitIndexTable.longest); n != 0; --n) {
+    if (n != str.size() && is_word(str[n]) && is_word(str[n-1]))
+      continue;
+    if (auto u = FindUnit(str.substr(0, n)); u != Unit::none)
+      return { u, n };
+  }
+  return { Unit::none, 0 };
+} // FindUnitPrefix
+
+static_assert(FindUnit("Tablespoons") == Unit::tbsp);
+static_assert(FindUnit("FL OZ") == Unit::floz);
+static_assert(FindUnit("cupx") == Unit::none);
+static_assert(FindUnit("cc") == Unit::ml);
+static_assert(FindRecipeUnit("cc") == Unit::none);
+static_assert(FindRecipeUnit("Cups") == Unit::cup);
+static_assert(FindUnitPrefix("cups, chopped").second == 4);
+static_assert(FindUnitPrefix("cupcake").first == Unit::none);
+
+#endif
@@ -0,0 +1,81 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#include "Writer.h"
+
+#include <ostream>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <type_traits>
+
+namespace {
+
+template<typename T>
+void AppendNumber(std::string& buf, T x) {
+  if constexpr (std::is_floating_point_v<T>) {
+    if (!std::isfinite(x)) {
+      buf += "null";
+      return;
+    }
+    if (x == 0)
+      x = 0;  // no "-0"
+  }
+  std::array<char, 32> digits;
+  auto [ptr, ec] = std::to_chars(digits.data(), digits.data() + digits.size(),
+				 x);
+  buf.append(digits.data(), ptr);
+} // AppendNumber
+
+} // local
+
+TextWriter& TextWriter::operator<<(int x) {
+  AppendNumber(buf, x);
+  return *this;
+}
+
+TextWriter& TextWriter::operator<<(float x) {
+  AppendNumber(buf, x);
+  return *this;
+}
+
+TextWriter& TextWriter::operator<<(double x) {
+  AppendNumber(buf, x);
+  return *this;
+}
+
+TextWriter& TextWriter::field(std::string_view str) {
+  for (char c: str)
+    buf.push_back((c == '\t' || c == '\n' || c == '\r') ? ' ' : c);
+  return *this;
+} // field
+
+TextWriter& TextWriter::quoted(std::string_view str) {
+  static constexpr char Hex[] = "0123456789abcdef";
+  buf.push_back('"');
+  for (char c: str) {
+    switch (c) {
+      case '"':  buf += "\\\""; break;
+      case '\\': buf += "\\\\"; break;
+      case '\n': buf += "\\n";  break;
+      case '\r': buf += "\\r";  break;
+      case '\t': buf += "\\t";  break;
+      default:
+	if (static_cast<unsigned char>(c) < 0x20) {
+	  buf += "\\u00";
+	  buf.push_back(Hex[(c >> 4) & 0xF]);
+	  buf.push_back(Hex[c & 0xF]);
+	}
+	else
+	  buf.push_back(c);
+	break;
+    }
+  }
+  buf.push_back('"');
+  return *this;
+} // quoted
+
+void TextWriter::flush() {
+  if (buf.empty())
+    return;
+  os.write(buf.data(), buf.size());
+  buf.clear();
+} // flush
@@ -0,0 +1,49 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+#ifndef WRITER_H
+#define WRITER_H
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Appends text and numbers to a buffer, formatting numbers with
+// std::to_chars, and writes the buffer to a stream in large blocks.
+class TextWriter {
+  std::ostream& os;
+  std::string buf;
+public:
+  static constexpr std::size_t BlockSize = 64 << 10;
+  explicit TextWriter(std::ostream& os_) : os{os_} { buf.reserve(BlockSize); }
+  TextWriter(const TextWriter&) = delete;
+  TextWriter& operator=(const TextWriter&) = delete;
+  ~TextWriter() { flush(); }
+
+  TextWriter& operator<<(std::string_view str) {
+    buf.append(str);
+    return *this;
+  }
+  TextWriter& operator<<(char ch) {
+    buf.push_back(ch);
+    return *this;
+  }
+  TextWriter& operator<<(int x);
+  // Shortest text that reads back as the same value.
+  TextWriter& operator<<(float x);
+  TextWriter& operator<<(double x);
+
+  // str with tabs and line breaks replaced by spaces.
+  TextWriter& field(std::string_view str);
+  // str as a quoted JSON string.
+  TextWriter& quoted(std::string_view str);
+
+  // Writes out the buffer if it has grown past BlockSize.
+  void sync() {
+    if (buf.size() >= BlockSize)
+      flush();
+  }
+  void flush();
+}; // TextWriter
+
+#endif
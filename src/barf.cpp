@@ -5,41 +5,25 @@
 #include <string>
 #include <iostream>
 #include <iomanip>
-#include <fstream>
-#include <vector>
+#include <algorithm>
 
 #include "Nutrition.h"
+#include "IngredDb.h"
 
 int main(int argc, const char* const argv[]) {
   using std::cout;
-  std::string ingred_dat;
   try {
-    if (argc == 1) {
-      gsl::czstring dir = std::getenv("INGRED_PATH");
-      if (!dir)
-	throw std::runtime_error{"INGRED_PATH not set"};
-      ingred_dat = dir + std::string{"/ingred.dat"};
-    }
-    const auto input_file = (argc == 1) ? ingred_dat : std::string{argv[1]}; 
-    auto input = std::ifstream{input_file, std::ios::binary};
-
-    std::vector<std::pair<std::string, Nutrition>> v;
-
-    std::string name;
-    Nutrition nutr;
-
-    while (std::getline(input, name, '\0')) {
-      input.read(reinterpret_cast<char*>(&nutr), sizeof(nutr));
-      v.emplace_back(name, nutr);
-    }
+    const auto input_file = (argc == 1) ? IngredDb::DefaultPath()
+					: std::string{argv[1]};
+    const auto db = IngredDb{input_file};
 
     std::string::size_type w = 0;
-    for (auto const& [x, y]: v)
-      w = std::max(w, x.size());
+    for (gsl::index i = 0; i != db.size(); ++i)
+      w = std::max(w, db.name(i).size());
 
-    for (auto const& [x, y]: v) {
-      std::cout << std::left << std::setw(w) << x << std::right
-	  << ' ' << y << '\n';
+    for (gsl::index i = 0; i != db.size(); ++i) {
+      std::cout << std::left << std::setw(w) << db.name(i) << std::right
+	  << ' ' << db.nutr(i) << '\n';
     }
 
     return EXIT_SUCCESS;
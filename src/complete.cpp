@@ -0,0 +1,87 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+
+#include "FoodDb.h"
+#include "IngredDb.h"
+
+#include <gsl/gsl>
+
+#include <string>
+#include <string_view>
+#include <span>
+#include <iostream>
+#include <charconv>
+#include <cstdlib>
+
+int main(int argc, const char* const argv[]) {
+  using std::cout;
+  try {
+    auto args = std::span{argv + 1, argv + argc};
+    bool usda = false;
+    std::size_t top = 10;
+    bool usage = false;
+    for (; !args.empty() && std::string_view{args[0]}.starts_with("--");
+	 args = args.subspan(1))
+    {
+      const std::string_view opt = args[0];
+      if (opt == "--usda") {
+	usda = true;
+      }
+      else if (opt.starts_with("--top=")) {
+	auto n = opt.substr(6);
+	auto [end, ec] = std::from_chars(n.data(), n.data() + n.size(), top);
+	usage |= (ec != std::errc{} || end != n.data() + n.size());
+      }
+      else {
+	usage = true;
+      }
+    }
+    if (args.empty() || usage) {
+      std::cerr << "usage: complete [--usda] [--top=N] prefix...\n"
+	"Lists the N (10) ingred.dat names that start with the prefix, "
+	"shortest first;\nwith --usda, the USDA foods whose descriptions "
+	"do, ignoring case, as\nfdc_id<tab>description.  The prefix's "
+	"words are joined by single spaces.\n";
+      return EXIT_FAILURE;
+    }
+    std::string prefix;
+    for (std::string_view arg: args) {
+      if (!prefix.empty())
+	prefix.push_back(' ');
+      prefix.append(arg);
+    }
+
+    std::string out;
+    if (usda) {
+      gsl::czstring dir = std::getenv("FOOD_PATH");
+      if (!dir)
+	throw std::runtime_error{"FOOD_PATH not set"};
+      const auto db = FoodDb{dir + std::string{"/usda_foods.bin"}};
+      for (const auto* food: db.complete(prefix, top)) {
+	out.append(std::to_string(food->fdc_id));
+	out.push_back('\t');
+	out.append(db.str(food->desc));
+	out.push_back('\n');
+      }
+    }
+    else {
+      const auto db = IngredDb{};
+      for (auto i: db.complete(prefix, top)) {
+	out.append(db.name(i));
+	out.push_back('\n');
+      }
+    }
+    cout << out << std::flush;
+
+    return EXIT_SUCCESS;
+  }
+  catch (const std::ios::failure& fail) {
+    cout << "ios::failure: " << fail.what()
+              << "\n    error code = " << fail.code().message() << std::endl;
+
+  }
+  catch (const std::exception& x) {
+    cout << "standard exception: " << x.what() << std::endl;
+  }
+
+  return EXIT_FAILURE;
+} // main
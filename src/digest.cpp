@@ -2,66 +2,114 @@
 
 #include "Nutrition.h"
 #include "Atwater.h"
+#include "IngredDb.h"
+#include "Normalize.h"
+#include "Ingredients.h"
+#include "FileWatch.h"
+#include "LineCursor.h"
 
 #include <gsl/gsl>
 
 #include <string>
-#include <map>
+#include <unordered_map>
 #include <stack>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <sstream>
 #include <regex>
+#include <mutex>
 #include <ranges>
 #include <algorithm>
 #include <cmath>
+#include <chrono>
 
 namespace rng = std::ranges;
 
-using NutritionMap = std::map<std::string, Nutrition>;
+using VarMap = TextMap;
 
-struct VarItem {
-  std::regex  re;
-  std::string str;
-}; // VarItem
-
-using VarMap = std::map<std::string, VarItem>;
-
-#define COUT cout << fname << '(' << linenum << ") "
+#define COUT db.log() << fname << '(' << linenum << ") "
 
 bool Contains(const std::string& str1, const auto& str2)
 { return (str1.find(str2) != std::string::npos); }
 
-void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
+struct SearchPattern {
+  std::regex re;
+  std::string literal;  // that every match contains
+}; // SearchPattern
+
+// Compiled /search/ patterns, by source text, for every thread.
+const SearchPattern& FindSearchPattern(std::string_view pattern) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, SearchPattern,
+			    StringHash, std::equal_to<>> cache;
+  auto lock = std::scoped_lock{mutex};
+  auto iter = cache.find(pattern);
+  if (iter == cache.end()) {
+    auto search = SearchPattern{
+      std::regex{pattern.begin(), pattern.end()}, RequiredLiteral(pattern)
+    };
+    iter = cache.emplace(pattern, std::move(search)).first;
+  }
+  return iter->second;
+} // FindSearchPattern
+
+// The files named by the #include lines that follow, up to the first line
+// that is not an #include or blank.  Counts the lines looked at, and puts
+// input back where it was.
+std::vector<std::string> IncludesAhead(std::istream& input, int& lines) {
+  static const std::regex e{"\\s*#\\s*include\\s*\"([^\"]+)\"\\s*"};
+  std::vector<std::string> fnames;
+  lines = 0;
+  if (input.eof())
+    return fnames;
+  const auto pos = input.tellg();
+  std::string line;
+  std::smatch s;
+  while (std::getline(input, line)) {
+    if (auto i = line.find("//"); i != std::string::npos)
+      line.erase(i);
+    if (std::regex_match(line, s, e))
+      fnames.push_back(s[1].str());
+    else if (line.find_first_not_of(" \t\n\r\f\v") != std::string::npos)
+      break;
+    ++lines;
+  }
+  input.clear();
+  input.seekg(pos);
+  return fnames;
+} // IncludesAhead
+
+void ReadIngredients(const std::string& fname, Ingredients& db)
 {
-  using std::cout;
-  auto input = std::ifstream(fname);
-  if (!input || !input.is_open()) {
-    cout << fname << ": could not read\n";
-    return;
+  std::string text;
+  {
+    auto file = std::ifstream(fname);
+    if (!file || !file.is_open()) {
+      db.log() << fname << ": could not read\n";
+      return;
+    }
+    std::ostringstream buf;
+    buf << file.rdbuf();
+    text = std::move(buf).str();
   }
+  if (db.replay(fname, text))
+    return;
+  db.begin(fname, text);
+  auto input = std::istringstream{text};
+  const auto& defs = db.defs();
   std::string line;
   int linenum = 0;
   std::string name;
   static const auto npos = std::string::npos;
   static const auto ws   = " \t\n\r\f\v";
-  static const std::regex dollars_re("\\$\\$");
   Nutrition nutr;
   std::string key;
   std::string dollars;
   VarMap vars;
   auto subst_vars = [&](std::string& str) {
-    if (!Contains(str, '$'))
-      return;
-    if (!dollars.empty())
-      str = std::regex_replace(str, dollars_re, dollars);
-    else if (Contains(str, "$$"))
+    if (!ExpandVars(str, vars, dollars))
       COUT << "$$ undefined\n";
-    if (vars.empty())
-      return;
-    for (const auto& [var, val]: vars)
-      str = std::regex_replace(str, val.re, val.str);
   }; // subst_vars
   bool allow_each = false;
   bool is_equal = false;
@@ -76,6 +124,7 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
   Atwater atwater;
   std::string this_name;
   Nutrition this_nutr;
+  int prefetched = 0;  // the last line of #includes parsed ahead
   while (std::getline(input, line)) {
     ++linenum;
 
@@ -90,8 +139,8 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
       if (line.empty())
 	continue;
 
-      if (std::regex_search(line, std::regex("^\\s*#"))) {
-	line = std::regex_replace(line, std::regex("^\\s*#\\s*"), "");
+      if (auto i = line.find_first_not_of(ws); i != npos && line[i] == '#') {
+	line.erase(0, line.find_first_not_of(ws, i + 1));
 	if (line == "endif") {
 	  if (if_blocks.empty()) {
 	    COUT << "unmatched #endif\n";
@@ -162,7 +211,17 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
 	    COUT << "invalid #include\n";
 	    continue;
 	  }
-	  ReadIngredients(s[1].str(), nuts, defs);
+	  if (linenum > prefetched) {
+	    // Parse this and the #includes right after it concurrently.
+	    int lines = 0;
+	    auto fnames = IncludesAhead(input, lines);
+	    if (!fnames.empty()) {
+	      fnames.insert(fnames.begin(), s[1].str());
+	      db.prefetch(fnames);
+	    }
+	    prefetched = linenum + lines;
+	  }
+	  db.read(s[1].str());
 	  continue;
 	}
 	if (line.starts_with("define")) {
@@ -176,8 +235,7 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
 	  else if (std::regex_match(line, s, e2)) {
 	    var = s[1].str();
 	    val = s[2].str();
-	    for (const auto& [dvar, dval]: defs)
-	      val = std::regex_replace(val, dval.re, dval.str);
+	    ExpandDefines(val, defs);
 	  }
 	  else {
 	    COUT << "invalid #define\n";
@@ -185,17 +243,11 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
 	  }
 
 	  auto iter = defs.find(var);
-	  if (iter == defs.end()) {
-	    defs.emplace(var, VarItem{std::regex{"\\b" + var + "\\b"}, val});
-	    continue;
-	  }
-
-	  auto& oldval = iter->second.str;
-	  if (val != oldval) {
+	  if (iter != defs.end() && val != iter->second) {
 	    COUT "redefining " << var << ": "
-	      << std::quoted(oldval) << " --> " << std::quoted(val) << '\n';
+	      << std::quoted(iter->second) << " --> " << std::quoted(val) << '\n';
 	  }
-	  oldval = val;
+	  db.define(var, val);
 	  continue;
 	}
 	if (line.starts_with("undef")) {
@@ -204,7 +256,11 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
 	    COUT << "invalid #undef\n";
 	    continue;
 	  }
-	  defs.erase(s[1].str());
+	  db.undef(s[1].str());
+	  continue;
+	}
+	if (line == "pragma once") {
+	  db.pragma_once();
 	  continue;
 	}
 	if (line.starts_with("echo")) {
@@ -214,8 +270,7 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
 	    continue;
 	  }
 	  auto str = line.substr(i);
-	  for (const auto& [dvar, dval]: defs)
-	    str = std::regex_replace(str, dval.re, dval.str);
+	  ExpandDefines(str, defs);
 	  COUT << str << '\n';
 	  continue;
 	}
@@ -225,20 +280,19 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
       if (ignore_flag)
 	continue;
 
-      for (const auto& [var, val]: defs)
-	line = std::regex_replace(line, val.re, val.str);
+      ExpandDefines(line, defs);
 
       // std::cout << line << '\n';
 
-      std::istringstream istr{line};
+      auto istr = LineCursor{line};
 
-      istr >> std::ws;
+      istr.ws();
       if (!istr)
 	continue;
 
       if (istr.peek() == ':') {
 	istr.ignore();
-	istr >> std::ws;
+	istr.ws();
 	if (istr.eof()) {
 	  dollars.clear();
 	  vars.clear();
@@ -246,7 +300,7 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
 	}
 	if (!Contains(line, '=')) {
 	  dollars.clear();
-	  std::getline(istr, dollars);
+	  istr.getline(dollars);
 	  continue;
 	}
 	static const auto e = std::regex{"\\s*:\\s*(\\w+)\\s*=\\s*(.*)"};
@@ -262,13 +316,14 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
 	  continue;
 	}
 	subst_vars(val);
-	vars[var] = VarItem{std::regex{"\\$" + var + "\\b"}, val};
+	vars[var] = val;
 	continue;
       }
 
       if (istr.peek() == '[') {
-	istr >> atwater;
-	if (!istr)
+	auto factors = std::istringstream{std::string{istr.rest()}};
+	factors >> atwater;
+	if (!factors)
 	  COUT << "invalid Atwater factors\n";
 	continue;
       }
@@ -282,15 +337,8 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
 	  continue;
 	}
 	// std::regex s{"\\b" + m[1].str() + "\\b"};
-	std::regex s{m[1].str()};
-	const auto& r = m[2].str();
-	std::vector<NutritionMap::value_type> add;
-	for (const auto& n: nuts) {
-	  if (std::regex_search(n.first, s))
-	    add.emplace_back(std::regex_replace(n.first, s, r), n.second);
-	}
-	for (auto& v: add)
-	  nuts.emplace(std::move(v));
+	const auto& search = FindSearchPattern(m[1].str());
+	db.search(search.re, search.literal, m[2].str());
   #if 0
 	COUT << std::quoted(m[1].str()) << " --> " << std::quoted(m[2].str())
 	     << " " << add.size() << " times\n";
@@ -301,14 +349,14 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
       allow_each = (istr.peek() == '*');
       if (allow_each) {
 	istr.ignore();
-	istr >> std::ws;
+	istr.ws();
       }
 
       nutr.zero();
       is_equal = (istr.peek() == '=');
       if (is_equal) {
 	istr.ignore();
-	istr >> std::ws >> std::quoted(key);
+	istr.ws().quoted(key);
 	if (!istr) {
 	  COUT << " invalid key\n";
 	  continue;
@@ -318,17 +366,17 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
 	  nutr = this_nutr;
 	}
 	else {
-	  auto iter = nuts.find(key);
-	  if (iter == nuts.end()) {
+	  auto n = db.find(key);
+	  if (!n) {
 	    COUT << "key not found: " << std::quoted(key) << '\n';
 	    continue;
 	  }
-	  nutr = iter->second;
+	  nutr = *n;
 	}
 	key.clear();
       }
       else {
-	istr >> nutr.g >> nutr.ml >> std::ws;
+	(istr >> nutr.g >> nutr.ml).ws();
 	if (!istr) {
 	  COUT << "invalid nutrition\n";
 	  continue;
@@ -351,7 +399,7 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
 	kcal_range_error = (istr.peek() == '?');
 	if (kcal_range_error)
 	  istr.ignore();
-	istr >> std::ws;
+	istr.ws();
 	key.clear();
 	if (auto c = istr.peek(); std::isdigit(c) || c == '.') {
 	  istr >> nutr.prot >> nutr.fat >> nutr.carb >> nutr.fiber;
@@ -363,14 +411,14 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
 	    throw std::runtime_error{"Invalid carbs: " + std::to_string(nutr.carb) + " < " + std::to_string(nutr.fiber)};
 	}
 	else {
-	  istr >> std::quoted(key);
+	  istr.quoted(key);
 	}
 	if (!istr) {
 	  COUT << "invalid macros\n";
 	  continue;
 	}
       }
-      std::getline(istr >> std::ws, name);
+      istr.ws().getline(name);
       if (!istr || name.empty()) {
 	COUT << "invalid name\n";
 	continue;
@@ -410,7 +458,7 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
 	  }
 	}
 
-	vars["this"] = VarItem{std::regex{"\\$this\\b"}, name};
+	vars["this"] = name;
 	this_name = name;
 	this_nutr = nutr;
       }
@@ -418,17 +466,16 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
       if (!key.empty()) {
 	subst_vars(key);
 
-	Nutrition* nptr = nullptr;;
+	const Nutrition* nptr = nullptr;
 	if (key == "this") {
 	  nptr = &this_nutr;
 	}
 	else {
-	  auto iter = nuts.find(key);
-	  if (iter == nuts.end()) {
+	  nptr = db.find(key);
+	  if (!nptr) {
 	    COUT << "key not found: " << std::quoted(key) << '\n';
 	    continue;
 	  }
-	  nptr = &iter->second;
 	}
 	auto const& n = *nptr;
 
@@ -488,7 +535,7 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
   #endif
 
       if (name == "replace") {
-	nuts[this_name] = this_nutr = nutr;
+	db.assign(this_name, this_nutr = nutr);
 	continue;
       }
 
@@ -505,51 +552,86 @@ void ReadIngredients(const std::string& fname, NutritionMap& nuts, VarMap& defs)
 	continue;
       }
 
-      if (Contains(name, "extra")) {
-	static const std::regex
-			    e{"\\bextra[ -](small|large|light|heavy)\\b"};
-	name = std::regex_replace(name, e, "x$1");
-      }
+      ExpandExtra(name);
 
       // substitute common synonyms
-      {
-	static const std::regex e1{"\\b(diced|cubed)\\b"};
-	static const std::regex e3{"\\bservings\\b"};
-	name = std::regex_replace(name, e1, "chopped");
-	name = std::regex_replace(name, e3, "serving");
-      }
+      SubstSynonyms(name);
 
-      if (!nuts.try_emplace(name, nutr).second)
+      if (!db.insert(name, nutr))
 	COUT << "duplicate: " << name << '\n';
     }
     catch (const std::exception& x) {
       COUT << "Exception: " << x.what() << '\n';
     }
   }
+  db.end();
 } // ReadIngredients
 
 int main(int argc, char* argv[]) {
   using std::cout;
   try {
-    std::string input_file = (argc == 1) ? "ingred.nut" :  argv[1];
-    NutritionMap ingredients;
-    VarMap defs;
-    ReadIngredients(input_file, ingredients, defs);
-    cout << "Read " << ingredients.size() << " ingredients." << std::endl;
-
+    int arg = 1;
+    const bool watch = (arg < argc && argv[arg] == std::string{"--watch"});
+    if (watch)
+      ++arg;
+    std::string input_file = (arg == argc) ? "ingred.nut" :  argv[arg];
     const auto dot_txt = std::regex{"\\.nut"};
     auto output_file = std::regex_replace(input_file, dot_txt, ".dat");
-    if (output_file == input_file)
-      throw std::runtime_error{"output = input: " + output_file};
-
-    auto output = std::ofstream{output_file, std::ios::binary};
-
-    for (const auto& [name, nutr]: ingredients) {
-      output.write(name.c_str(), name.size()+1);
-      output.write(reinterpret_cast<const char*>(&nutr), sizeof(nutr));
+    auto cache_file = std::regex_replace(input_file, dot_txt, ".cache");
+
+    // Files unchanged since the last run are replayed from the cache.
+    Ingredients db{ReadIngredients};
+    if (cache_file != input_file)
+      db.load(cache_file);
+
+    auto digest = [&]() {
+      db.read(input_file);
+      const auto& ingredients = db.table();
+      cout << db.messages();
+      cout << "Read " << ingredients.size() << " ingredients." << std::endl;
+
+      if (output_file == input_file)
+	throw std::runtime_error{"output = input: " + output_file};
+
+      // Replaced atomically: nut never reads a partly written file.
+      IngredDbWriter output;
+      for (auto e: ingredients.sorted())
+	output.add(e->name, e->nutr);
+      output.write(output_file);
+      db.save(cache_file);
+    };
+
+    if (!watch) {
+      digest();
+      return EXIT_SUCCESS;
     }
 
-    return EXIT_SUCCESS;
+    // Digest again whenever a file that was read changes, keeping the
+    // records of every file in memory.  Watch before reading, so that a
+    // file saved while it is being digested is digested again.  A file in
+    // a directory first watched after the digest may have been saved
+    // before the watch began, so those read are checked once it has.
+    using namespace std::chrono;
+    FileWatch files;
+    files.watch({input_file});
+    for (;;) {
+      bool ok = false;
+      try {
+	auto start = steady_clock::now();
+	digest();
+	auto ms = duration_cast<milliseconds>(steady_clock::now() - start);
+	cout << "Digested in " << ms.count() << " ms; watching "
+	     << db.files().size() << " files." << std::endl;
+	ok = true;
+      }
+      catch (const std::exception& x) {
+	cout << "standard exception: " << x.what() << std::endl;
+      }
+      files.watch(db.files());
+      if (!ok || !db.changed())
+	files.wait(milliseconds{100});
+      db.restart();
+    }
   }
   catch (const std::ios::failure& fail) {
     cout << "ios::failure: " << fail.what()
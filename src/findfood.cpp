@@ -0,0 +1,188 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+
+#include "CaselessSearch.h"
+#include "FoodDb.h"
+#include "MappedFile.h"
+#include "IngredDb.h"
+
+#include <gsl/gsl>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <iostream>
+#include <charconv>
+#include <ranges>
+#include <algorithm>
+#include <tuple>
+#include <cstdlib>
+
+namespace rng = std::ranges;
+
+// The terms, longest first: the longest is searched for and the others
+// are looked for only in the lines it is in.  An empty term matches all.
+std::vector<CaselessSearch> Terms(std::span<const char* const> args) {
+  std::vector<CaselessSearch> terms;
+  for (std::string_view arg: args) {
+    if (!arg.empty())
+      terms.emplace_back(arg);
+  }
+  rng::stable_sort(terms, rng::greater{}, &CaselessSearch::size);
+  return terms;
+} // Terms
+
+bool MatchesAll(std::string_view line, std::span<const CaselessSearch> terms)
+{ return rng::all_of(terms, [line](const auto& t) { return t.in(line); }); }
+
+// The lines of food.txt ("fdc_id<tab>|description") that contain every
+// term, ignoring case.
+std::vector<std::string_view> FindFoods(std::string_view text,
+				        std::span<const CaselessSearch> terms)
+{
+  std::vector<std::string_view> lines;
+  if (terms.empty()) {
+    for (auto line: rng::views::split(text, '\n')) {
+      if (!line.empty())
+	lines.emplace_back(line.begin(), line.end());
+    }
+    return lines;
+  }
+  const auto& first = terms.front();
+  for (std::size_t pos = 0;
+       (pos = first.find(text, pos)) != CaselessSearch::npos; )
+  {
+    auto begin = text.rfind('\n', pos);
+    begin = (begin == std::string_view::npos) ? 0 : begin + 1;
+    auto end = text.find('\n', pos);
+    if (end == std::string_view::npos)
+      end = text.size();
+    const auto line = text.substr(begin, end - begin);
+    if (MatchesAll(line, terms.subspan(1)))
+      lines.push_back(line);
+    pos = end + 1;
+  }
+  return lines;
+} // FindFoods
+
+// The best k matches for the words of the terms, from the BM25 index in
+// usda_foods.bin, as "fdc_id<tab>score<tab>description".
+std::string RankFoods(const std::string& dir,
+		      std::span<const char* const> args, std::size_t k)
+{
+  const auto db = FoodDb{dir + "/usda_foods.bin"};
+  std::string query;
+  for (std::string_view arg: args) {
+    query.append(arg);
+    query.push_back(' ');
+  }
+  std::string out;
+  for (const auto& [food, score]: db.rank(query, k)) {
+    char buf[32];
+    out.append(std::to_string(food->fdc_id));
+    out.push_back('\t');
+    auto end = std::to_chars(buf, buf + sizeof(buf), score,
+			     std::chars_format::fixed, 3).ptr;
+    out.append(buf, end);
+    out.push_back('\t');
+    out.append(db.str(food->desc));
+    out.push_back('\n');
+  }
+  return out;
+} // RankFoods
+
+int main(int argc, const char* const argv[]) {
+  using std::cout;
+  try {
+    auto args = std::span{argv + 1, argv + argc};
+    bool ingred = false;
+    bool rank = false;
+    std::size_t top = 20;
+    bool usage = false;
+    for (; !args.empty() && std::string_view{args[0]}.starts_with("--");
+	 args = args.subspan(1))
+    {
+      const std::string_view opt = args[0];
+      if (opt == "--ingred") {
+	ingred = true;
+      }
+      else if (opt == "--rank") {
+	rank = true;
+      }
+      else if (opt.starts_with("--top=")) {
+	auto n = opt.substr(6);
+	auto [end, ec] = std::from_chars(n.data(), n.data() + n.size(), top);
+	usage |= (ec != std::errc{} || end != n.data() + n.size() || top == 0);
+      }
+      else {
+	usage = true;
+      }
+    }
+    if (args.empty() || usage || (rank && ingred)) {
+      std::cerr << "usage: findfood [--ingred] term...\n"
+	"       findfood --rank [--top=N] word...\n"
+	"Lists the USDA foods whose descriptions contain every term, "
+	"ignoring case,\nsorted by description; with --ingred, then the "
+	"ingred.dat names that do.\nWith --rank, lists the N (20) foods "
+	"whose descriptions best match the words,\nbest first, by BM25.\n";
+      return EXIT_FAILURE;
+    }
+
+    gsl::czstring dir = std::getenv("FOOD_PATH");
+    if (!dir)
+      throw std::runtime_error{"FOOD_PATH not set"};
+    if (rank) {
+      cout << RankFoods(dir, args, top) << std::flush;
+      return EXIT_SUCCESS;
+    }
+
+    const auto terms = Terms(args);
+    const auto food = MappedFile{dir + std::string{"/food.txt"}};
+
+    // Sorted as by "sort +1", by description and then the whole line.
+    auto lines = FindFoods(food.view(), terms);
+    auto desc = [](std::string_view line) {
+      auto tab = line.find('\t');
+      return (tab == std::string_view::npos) ? line : line.substr(tab);
+    };
+    rng::sort(lines, [&desc](auto lhs, auto rhs) {
+      return std::tuple{desc(lhs), lhs} < std::tuple{desc(rhs), rhs};
+    });
+    std::string out;
+    for (auto line: lines) {
+      auto bar = line.find('|');
+      if (bar == std::string_view::npos) {
+	out.append(line);
+      }
+      else {
+	out.append(line.substr(0, bar));
+	out.append(line.substr(bar + 1));
+      }
+      out.push_back('\n');
+    }
+
+    if (ingred) {
+      const auto db = IngredDb{};
+      for (gsl::index i = 0; i != db.size(); ++i) {
+	if (MatchesAll(db.name(i), terms)) {
+	  out.append("ingred\t");
+	  out.append(db.name(i));
+	  out.push_back('\n');
+	}
+      }
+    }
+    cout << out << std::flush;
+
+    return EXIT_SUCCESS;
+  }
+  catch (const std::ios::failure& fail) {
+    cout << "ios::failure: " << fail.what()
+              << "\n    error code = " << fail.code().message() << std::endl;
+
+  }
+  catch (const std::exception& x) {
+    cout << "standard exception: " << x.what() << std::endl;
+  }
+
+  return EXIT_FAILURE;
+} // main
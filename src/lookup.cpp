@@ -1,8 +1,9 @@
 // Copyright 2023-2024 Terry Golubiewski, all rights reserved.
 
 #include "Atwater.h"
+#include "FoodDb.h"
 #include "To.h"
-#include "Parse.h"
+#include "Units.h"
 
 #include <system_error>
 #include <ranges>
@@ -132,59 +133,24 @@ auto ReadFoods()
   return foods;
 } // ReadFoods
 
-void LoadNutrients(std::vector<Ingred>& foods) {
-  std::map<FdcId, Ingred*> food_map;
-  for (auto& ingred: foods)
-    food_map.emplace(ingred.id, &ingred);
-
-  const auto fname = DbPath + "usda_foods.tsv";
-  auto db = std::ifstream{fname};
-  if (!db)
-    throw std::runtime_error("Cannot open " + fname);
-  enum class Idx
-      { fdc_id, kcal, prot, fat, carb, fiber, alc, atwater, desc, end };
-  static const std::array<std::string_view, int(Idx::end)> headings = {
-    "fdc_id",
-    "kcal",
-    "prot",
-    "fat",
-    "carb",
-    "fiber",
-    "alc",
-    "atwater",
-    "desc"
-  }; // headings
-  std::string line;
-  ParseVec<Idx> v;
-  if (!std::getline(db, line))
-    throw std::runtime_error("Cannot read " + fname);
-  ParseTsv(v, line);
-  CheckHeadings(v, headings);
-  int linenum = 1;
-  int found = 0;
-  while (std::getline(db, line)) {
+void LoadNutrients(std::vector<Ingred>& foods, const FoodDb& db) {
+  for (auto& ingred: foods) {
+    auto food = db.find(std::uint32_t(ingred.id));
+    if (!food)
+      continue;
     try {
-      ++linenum;
-      ParseTsv(v, line);
-      auto fdc_id = FdcId{To<int>(v[Idx::fdc_id])};
-      auto food = food_map.find(fdc_id);
-      if (food == food_map.end())
-	continue;
-      ++found;
-      auto ingred = food->second;
-      ingred->id      = fdc_id;
-      ingred->kcal    = To<float>(v[Idx::kcal]);
-      ingred->protein = To<float>(v[Idx::prot]);
-      ingred->fat     = To<float>(v[Idx::fat]);
-      ingred->carb    = To<float>(v[Idx::carb]);
-      ingred->fiber   = To<float>(v[Idx::fiber]);
-      ingred->alcohol = To<float>(v[Idx::alc]);
-      ingred->atwater = Atwater{v[Idx::atwater]};
-      if (ingred->desc.empty())
-        ingred->desc    = std::string(v[Idx::desc]);
+      ingred.kcal    = food->kcal;
+      ingred.protein = food->protein;
+      ingred.fat     = food->fat;
+      ingred.carb    = food->carb;
+      ingred.fiber   = food->fiber;
+      ingred.alcohol = food->alcohol;
+      ingred.atwater = Atwater{db.str(food->atwater)};
+      if (ingred.desc.empty())
+	ingred.desc = db.str(food->desc);
     }
     catch (std::exception& x) {
-      std::cerr << fname << '(' << linenum << ") " << x.what() << '\n';
+      std::cerr << "fdc_id " << ingred.id << ": " << x.what() << '\n';
     }
   }
 } // LoadNutrients
@@ -207,49 +173,27 @@ std::ostream& operator<<(std::ostream& os, const Portion& p) {
   return os << '{' << p.id << ' ' << p.g << ' ' << p.ml << ' ' << p.desc << '}';
 } // << Portion
 
-auto LoadPortions(const std::vector<Ingred>& foods)
+auto LoadPortions(const std::vector<Ingred>& foods, const FoodDb& db)
   -> std::vector<Portion>
 {
-  const auto fname = DbPath + "usda_portions.tsv";
-  auto input = std::ifstream(fname);
-  if (!input)
-    throw std::runtime_error("Cannot open " + fname);
   std::vector<FdcId> fdc_ids;
   fdc_ids.reserve(foods.size());
   rng::transform(foods, std::back_inserter(fdc_ids), &Ingred::id);
   rng::sort(fdc_ids);
-  enum class Idx { fdc_id, g, ml, desc, comment, end };
-  static const std::array<std::string_view, int(Idx::end)> headings = {
-    "fdc_id",
-    "g",
-    "ml",
-    "desc",
-    "comment"
-  }; // headings
+  const auto [first, last] = rng::unique(fdc_ids);
+  fdc_ids.erase(first, last);
+  // Each food's portions are stored in order.
   std::vector<Portion> rval;
-  std::string line;
-  ParseVec<Idx> v;
-  if (!std::getline(input, line))
-    throw std::runtime_error("Cannot read " + fname);
-  ParseTsv(v, line);
-  CheckHeadings(v, headings);
-  int linenum = 1;
-  while (std::getline(input, line)) {
-    try {
-      ++linenum;
-      ParseTsv(v, line);
-      auto fdc_id = FdcId{To<int>(v[Idx::fdc_id])};
-      if (!rng::binary_search(fdc_ids, fdc_id))
-	continue;
-      rval.emplace_back(fdc_id, To<float>(v[Idx::g]), To<float>(v[Idx::ml]),
-			std::string{v[Idx::desc]},
-			std::string{v[Idx::comment]});
-    }
-    catch (std::exception& x) {
-      std::cerr << fname << '(' << linenum << ") " << x.what() << '\n';
+  for (auto fdc_id: fdc_ids) {
+    auto food = db.find(std::uint32_t(fdc_id));
+    if (!food)
+      continue;
+    for (const auto& p: db.portions(*food)) {
+      rval.emplace_back(fdc_id, p.g, p.ml,
+			std::string{db.str(p.desc)},
+			std::string{db.str(p.comment)});
     }
   }
-  rng::sort(rval);
   return rval;
 } // LoadPortions
 
@@ -262,13 +206,13 @@ private:
   std::map<float, std::string> dict;
 public:
   MlText() {
-    constexpr auto FlOz = 29.5735f;
-    constexpr auto Cup  = 8 * FlOz;
-    constexpr auto Tbsp = Cup / 16;
-    constexpr auto Tsp  = Tbsp / 3;
-    constexpr auto Pint = 2 * Cup;
-    constexpr auto Quart = 4 * Cup;
-    constexpr auto Gallon = 4 * Quart;
+    constexpr auto FlOz   = float(Volume{1, Unit::floz}.ml);
+    constexpr auto Cup    = float(Volume{1, Unit::cup}.ml);
+    constexpr auto Tbsp   = float(Volume{1, Unit::tbsp}.ml);
+    constexpr auto Tsp    = float(Volume{1, Unit::tsp}.ml);
+    constexpr auto Pint   = float(Volume{1, Unit::pt}.ml);
+    constexpr auto Quart  = float(Volume{1, Unit::qt}.ml);
+    constexpr auto Gallon = float(Volume{1, Unit::gal}.ml);
     dict.emplace(Round(FlOz),   "FLOZ");
     dict.emplace(Round(Cup),    "CUP");
     dict.emplace(Round(Cup/2),  "HCUP");
@@ -305,9 +249,11 @@ int main() {
 
     auto foods = ReadFoods();
 
-    LoadNutrients(foods);
+    const auto db = FoodDb{DbPath + "usda_foods.bin"};
+
+    LoadNutrients(foods, db);
 
-    const auto portions = LoadPortions(foods);
+    const auto portions = LoadPortions(foods, db);
 
     const auto fname = "lookout.nut"s;
     auto output = std::ofstream(fname);
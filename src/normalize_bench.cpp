@@ -0,0 +1,121 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+
+// Times ExpandExtra plus SubstLookupSynonyms, as nut applies them to
+// each recipe line, against the std::regex versions they replaced.
+
+#include "Normalize.h"
+
+#include <ranges>
+#include <algorithm>
+#include <regex>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <iostream>
+#include <iomanip>
+#include <charconv>
+#include <cstdlib>
+
+namespace rng = std::ranges;
+
+namespace old {
+
+bool Replace(std::string& str, const std::regex& e, const char* fmt) {
+  auto rval = std::regex_replace(str, e, fmt);
+  if (rval == str)
+    return false;
+  str = std::move(rval);
+  return true;
+} // Replace
+
+bool ExpandExtra(std::string& name) {
+  if (name.find("extra") == std::string::npos)
+    return false;
+  static const std::regex e{"\\bextra[ -](small|large|light|heavy)\\b"};
+  return Replace(name, e, "x$1");
+} // ExpandExtra
+
+bool SubstLookupSynonyms(std::string& name) {
+  auto changed = (name.find('-') != std::string::npos);
+  rng::replace(name, '-', ' ');
+  static const std::regex e1{"\\b(diced|cubed)\\b"};
+  static const std::regex e3{"\\bservings\\b"};
+  changed = Replace(name, e1, "chopped") || changed;
+  changed = Replace(name, e3, "serving") || changed;
+  static const std::regex e2{"\\bdry\\b"};
+  return Replace(name, e2, "dried") || changed;
+} // SubstLookupSynonyms
+
+} // old
+
+namespace {
+
+// Recipe-style names, most of which no rule changes.
+constexpr std::string_view Names[] = {
+  "whole milk", "extra large eggs", "diced tomatoes", "all-purpose flour",
+  "dry white wine", "unsalted butter", "extra-virgin olive oil",
+  "cubed potatoes", "baking soda", "2 servings rice", "brown sugar",
+  "boneless skinless chicken breast", "garlic", "extra light olive oil",
+  "kosher salt", "ground black pepper", "dry-roasted peanuts", "honey"
+};
+
+using Clock = std::chrono::steady_clock;
+
+// Seconds to apply expand and subst to a copy of each name.
+template<class Expand, class Subst>
+double Time(const std::vector<std::string>& names, Expand expand, Subst subst,
+	    long& changed)
+{
+  const auto start = Clock::now();
+  std::string name;
+  for (const auto& n: names) {
+    name = n;
+    changed += expand(name);
+    changed += subst(name);
+  }
+  return std::chrono::duration<double>(Clock::now() - start).count();
+} // Time
+
+} // local
+
+int main(int argc, const char* const argv[]) {
+  using std::cout;
+  try {
+    auto args = std::span{argv + 1, argv + argc};
+    std::size_t count = 1'000'000;
+    if (!args.empty()) {
+      std::string_view n = args[0];
+      auto [end, ec] = std::from_chars(n.data(), n.data() + n.size(), count);
+      if (args.size() != 1 || ec != std::errc{} || end != n.data() + n.size()) {
+	std::cerr << "usage: normalize_bench [count]\n";
+	return EXIT_FAILURE;
+      }
+    }
+
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (std::size_t i = 0; i != count; ++i)
+      names.emplace_back(Names[i % std::size(Names)]);
+
+    long changed = 0, old_changed = 0;
+    const auto now = Time(names, ExpandExtra, SubstLookupSynonyms, changed);
+    const auto was = Time(names, old::ExpandExtra, old::SubstLookupSynonyms,
+			  old_changed);
+    cout << std::fixed << std::setprecision(3)
+	 << count << " names: " << now << " s, regex " << was << " s ("
+	 << std::setprecision(1) << was / now << "x)" << std::endl;
+    if (changed != old_changed) {
+      cout << "normalize_bench: " << changed << " changes, regex "
+	   << old_changed << std::endl;
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  }
+  catch (const std::exception& x) {
+    cout << "standard exception: " << x.what() << std::endl;
+  }
+
+  return EXIT_FAILURE;
+} // main
@@ -0,0 +1,139 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+
+// Compares ExpandExtra, SubstSynonyms and SubstLookupSynonyms with the
+// std::regex versions they replaced, on random names built from the
+// words the rules look for, their neighbors, and separators.
+
+#include "Normalize.h"
+
+#include <ranges>
+#include <algorithm>
+#include <regex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <span>
+#include <iostream>
+#include <charconv>
+#include <cstdlib>
+
+namespace rng = std::ranges;
+
+namespace old {
+
+bool Replace(std::string& str, const std::regex& e, const char* fmt) {
+  auto rval = std::regex_replace(str, e, fmt);
+  if (rval == str)
+    return false;
+  str = std::move(rval);
+  return true;
+} // Replace
+
+bool ExpandExtra(std::string& name) {
+  if (name.find("extra") == std::string::npos)
+    return false;
+  static const std::regex e{"\\bextra[ -](small|large|light|heavy)\\b"};
+  return Replace(name, e, "x$1");
+} // ExpandExtra
+
+bool SubstSynonyms(std::string& name) {
+  static const std::regex e1{"\\b(diced|cubed)\\b"};
+  static const std::regex e3{"\\bservings\\b"};
+  auto changed = Replace(name, e1, "chopped");
+  return Replace(name, e3, "serving") || changed;
+} // SubstSynonyms
+
+bool SubstLookupSynonyms(std::string& name) {
+  auto changed = (name.find('-') != std::string::npos);
+  rng::replace(name, '-', ' ');
+  changed = SubstSynonyms(name) || changed;
+  static const std::regex e2{"\\bdry\\b"};
+  return Replace(name, e2, "dried") || changed;
+} // SubstLookupSynonyms
+
+} // old
+
+namespace {
+
+constexpr std::string_view Words[] = {
+  "extra", "small", "large", "light", "heavy", "diced", "cubed",
+  "servings", "serving", "dry", "dried", "chopped", "xsmall", "extras",
+  "extrasmall", "xextra", "dicedx", "predry", "Extra", "DICED", "dry_",
+  "_dry", "2", "cup", "milk", "a", "\xc3\xa9", "\xc3\xa9t\xc3\xa9"
+};
+
+constexpr std::string_view Separators[] = {
+  " ", " ", " ", "-", "-", "--", "\t", "  ", "_", "", ",", "(", ")", "'"
+};
+
+std::string RandomName(std::mt19937& gen) {
+  auto pick = [&gen](auto& set) {
+    return set[std::uniform_int_distribution<std::size_t>{
+		 0, std::size(set) - 1}(gen)];
+  };
+  const auto words = std::uniform_int_distribution{0, 8}(gen);
+  std::string name;
+  if (gen() % 4 == 0)
+    name += pick(Separators);
+  for (int w = 0; w != words; ++w) {
+    if (w != 0)
+      name += pick(Separators);
+    name += pick(Words);
+  }
+  if (gen() % 4 == 0)
+    name += pick(Separators);
+  return name;
+} // RandomName
+
+// Applies f and g to copies of name; true if they agree.
+bool Agree(const char* what, const std::string& name,
+	   bool (*f)(std::string&), bool (*g)(std::string&))
+{
+  auto a = name, b = name;
+  const auto fa = f(a), fb = g(b);
+  if (a == b && fa == fb)
+    return true;
+  std::cout << what << "(\"" << name << "\"): \"" << a << "\" " << fa
+	    << ", regex \"" << b << "\" " << fb << '\n';
+  return false;
+} // Agree
+
+} // local
+
+int main(int argc, const char* const argv[]) {
+  using std::cout;
+  try {
+    auto args = std::span{argv + 1, argv + argc};
+    long count = 300'000;
+    if (!args.empty()) {
+      std::string_view n = args[0];
+      auto [end, ec] = std::from_chars(n.data(), n.data() + n.size(), count);
+      if (args.size() != 1 || ec != std::errc{} || end != n.data() + n.size()) {
+	std::cerr << "usage: normalize_test [count]\n";
+	return EXIT_FAILURE;
+      }
+    }
+
+    std::mt19937 gen{20260416};
+    long failed = 0;
+    for (long i = 0; i != count && failed < 20; ++i) {
+      const auto name = RandomName(gen);
+      failed += !Agree("ExpandExtra", name, ExpandExtra, old::ExpandExtra);
+      failed += !Agree("SubstSynonyms", name,
+		       SubstSynonyms, old::SubstSynonyms);
+      failed += !Agree("SubstLookupSynonyms", name,
+		       SubstLookupSynonyms, old::SubstLookupSynonyms);
+    }
+    if (failed != 0) {
+      cout << "normalize_test: FAILED" << std::endl;
+      return EXIT_FAILURE;
+    }
+    cout << "normalize_test: " << count << " names OK" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch (const std::exception& x) {
+    cout << "standard exception: " << x.what() << std::endl;
+  }
+
+  return EXIT_FAILURE;
+} // main
@@ -1,28 +1,47 @@
 // Copyright 2023 Terry Golubiewski, all rights reserved.
 
 #include "Nutrition.h"
+#include "IngredDb.h"
+#include "Normalize.h"
+#include "Quantity.h"
+#include "Units.h"
+#include "ReportFormat.h"
+#include "Socket.h"
+#include "Writer.h"
+#include "To.h"
 
 #include <gsl/gsl>
 
-#include <regex>
 #include <ranges>
 #include <algorithm>
 #include <optional>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <sstream>
+#include <spanstream>
 #include <iostream>
 #include <iomanip>
-#include <fstream>
 #include <iterator>
+#include <utility>
+#include <thread>
+#include <chrono>
+#include <future>
+#include <atomic>
+#include <semaphore>
+#include <filesystem>
+#include <system_error>
+#include <new>
+#include <fstream>
+#include <span>
+#include <charconv>
 #include <cmath>
-#include <cstring>
 #include <cctype>
 #include <cstdlib>
 
 namespace rng = std::ranges;
-using namespace std::string_literals;
 
 class PrecSaver {
   std::ostream& os;
@@ -39,78 +58,45 @@ public:
   }
 }; // PrecSaver
 
-struct Ingredient {
-  std::string name;
+// An ingredient matched by a recipe line, and its share of the recipe.
+struct Match {
+  std::string_view ingredient;  // as named in ingred.dat
+  double ratio = 0.0;
   Nutrition nutr;
-  auto operator<=>(const Ingredient&) const = default;
-}; // Ingredient
-
-using NutrVec = std::vector<Ingredient>;
-
-void ReadIngredients(NutrVec& ingredients) {
-  gsl::czstring dir = std::getenv("INGRED_PATH");
-  if (!dir)
-    throw std::runtime_error("INGRED_PATH not set");
-  const auto fname = dir + "/ingred.dat"s;
-  std::ifstream input{fname, std::ios::binary};
-  if (!input || !input.is_open())
-    throw std::runtime_error(fname + ": cannot read"s);
-  Ingredient ingr;
-  while (std::getline(input, ingr.name, '\0')) {
-    input.read(reinterpret_cast<char*>(&ingr.nutr), sizeof(ingr.nutr));
-    ingr.nutr.fiber = std::max(0.0f, ingr.nutr.fiber); // remove alcohol
-    ingredients.push_back(ingr);
-  }
-  if (!rng::is_sorted(ingredients))
-    throw std::runtime_error(fname + " is not sorted"s);
-} // ReadIngredients
+  bool missing = false;  // a name was given but not found
+  std::vector<std::string_view> suggestions{};  // if missing, nearest first
+}; // Match
 
-auto FindIngredient(const NutrVec& ingredients,
-                    const std::string& name)
-  -> std::optional<Nutrition>
-{
-  if (name.empty())
-    return std::nullopt;
+// How many names nut suggests for one it cannot find.
+constexpr std::size_t MaxSuggestions = 3;
 
-  auto i = rng::lower_bound(ingredients, name, {}, &Ingredient::name);
-  if (i == ingredients.end() || i->name != name)
+// Matches name, or else synonym, its rewrite by SubstLookupSynonyms.
+auto FindIngredient(const IngredDb& ingredients, std::string_view name,
+		    std::string_view synonym)
+  -> std::optional<Match>
+{
+  auto i = ingredients.lookup(name, synonym);
+  if (!i)
     return std::nullopt;
 
-  return i->nutr;
+  auto match = Match{ingredients.name(*i), 0.0, ingredients.nutr(*i)};
+  match.nutr.fiber = std::max(0.0f, match.nutr.fiber); // remove alcohol
+  return match;
 } // FindIngredient
 
-auto FindIngredientWithPlurals(const NutrVec& ingredients,
-			       std::string name)
-  -> std::optional<Nutrition>
-{
-  auto nutr = FindIngredient(ingredients, name);
-  if (nutr || name.size() <= 1 || name.back() != 's')
-    return nutr;
-  name.pop_back();
-  nutr = FindIngredient(ingredients, name);
-  if (nutr || name.size() <= 1 || name.back() != 'e')
-    return nutr;
-  name.pop_back();
-  nutr = FindIngredient(ingredients, name);
-  if (nutr || name.size() <= 1 || name.back() != 'i')
-    return nutr;
-  name.back() = 'y';
-  return FindIngredient(ingredients, name);
-} // FindIngredientWithPlurals
-
 unsigned char ToLower(unsigned char c) { return std::tolower(c); }
 
-std::string ToLower(const std::string& str) {
-  std::string result;
-  result.reserve(str.size());
-  auto to_lower = [](unsigned char c) -> unsigned char
-    { return std::tolower(c); };
-  rng::transform(str, std::back_inserter(result), to_lower);
-  return result;
+// Appends the lower-case of src to dst.
+void AppendLower(std::string& dst, std::string_view src) {
+  auto to_lower = [](unsigned char c) -> char { return std::tolower(c); };
+  rng::transform(src, std::back_inserter(dst), to_lower);
 }
 
-void TrimLeadingWs(std::string& str)
-{ str.erase(0, str.find_first_not_of(" \t\n\r\f\v")); }
+bool IEquals(std::string_view str1, std::string_view str2) {
+  return rng::equal(str1, str2, {},
+		    [](unsigned char c) { return std::tolower(c); },
+		    [](unsigned char c) { return std::tolower(c); });
+}
 
 void TrimTrailingWs(std::string& str) {
   auto i = str.find_last_not_of(" \t\n\r\f\v");
@@ -118,462 +104,740 @@ void TrimTrailingWs(std::string& str) {
     str.erase(i);
 }
 
-bool ContainsAny(const std::string& str1, const std::string& str2)
-{ return (str1.find_first_of(str2) != std::string::npos); }
-
-bool Contains(const std::string& str1, const std::string& str2)
-{ return (str1.find(str2) != std::string::npos); }
-
-bool Contains(const std::string& str1, gsl::czstring str2)
-{ return (str1.find(str2) != std::string::npos); }
-
-bool Contains(const std::string& str, char ch)
-{ return (str.find(ch) != std::string::npos); }
-
-bool Contains(gsl::czstring str, char ch)
-{ return (std::strchr(str, ch) != nullptr); }
-
-const std::map<std::string, std::string> FractionMap = {
-  { "¼", "1/4" },
-  { "½", "1/2" },
-  { "¾", "3/4" },
-  { "⅓", "1/3" },
-  { "⅔", "2/3" },
-  { "⅛", "1/8" },
-  { "⅜", "3/8" },
-  { "⅝", "5/8" },
-  { "⅞", "7/8" }
-}; // FractionMap
-
-std::string SubstFraction(const std::string& str) {
-  if (str.empty())
-    return str;
-  for (const auto& s: FractionMap) {
-    auto i = str.find(s.first);
-    if (i == std::string::npos)
-      continue;
-    std::string rval;
-    if (i != 0) {
-      rval = str.substr(0, i);
-      if (std::isdigit(str[i-1]))
-	rval += ' ';
-    }
-    rval += s.second;
-    i += s.first.size();
-    if (i < str.size() && std::isdigit(str[i]))
-      rval += ' ';
-    return rval += str.substr(i);
-  }
-  return str;
-} // SubstFraction
-
-double Value(const std::string& arg) {
-  if (arg.empty())
-    return 0;
-  auto str = SubstFraction(arg);
-  if (Contains(str, '.') || !ContainsAny(str, "-/ ")) {
-    std::size_t pos = 0;
-    double rval = 0.0;
-    try { rval = std::stod(str, &pos); }
-    catch (...) { return 0; }
-    if (pos != str.size())
-      return 0;
-    return rval;
-  }
-  std::istringstream iss(str);
-  int base = 0;
-  iss >> base;
-  if (!iss || base < 0)
-    return 0;
-  switch (iss.peek()) {
-    case '/': {
-      iss.ignore();
-      int den = 0;
-      iss >> den;
-      if (!iss || !iss.eof() || den <= base)
-	return 0;
-      return double(base) / den;
-    }
-    case ' ':
-    case '-':
-      iss.ignore();
-      break;
-    default:
-      return 0;
-  }
-  int num = 0;
-  iss >> num;
-  if (!iss || num <= 0 || iss.peek() != '/')
-    return 0;
-  iss.ignore();
-  int den = 0;
-  iss >> den;
-  if (!iss || den <= num || !iss.eof())
-    return 0;
-  return base + double(num) / den;
-} // Value
+bool ContainsAny(std::string_view str1, std::string_view str2)
+{ return (str1.find_first_of(str2) != std::string_view::npos); }
 
-const std::map<std::string, std::string> UnitSyn = {
-  { "#",       "lb"   },
-  { "T",       "tbsp" },
-  { "c",       "cup"  },
-  { "cups",    "cup"  },
-  { "each",    "ea"   },
-  { "gallon",  "gal"  },
-  { "gallons", "gal"  },
-  { "gram" ,   "g"    },
-  { "grams",   "g"    },
-  { "liter",   "l"    },
-  { "liters",  "l"    },
-  { "ounce",   "oz"   },
-  { "ounces",  "oz"   },
-  { "piece",   "ea"   },
-  { "pieces",  "ea"   },
-  { "pint",    "pt"   },
-  { "pints",   "pt"   },
-  { "pound",   "lb"   },
-  { "pounds",  "lb"   },
-  { "quart",   "qt"   },
-  { "quarts",  "qt"   },
-  { "shots",   "shot" },
-  { "t",       "tsp"  },
-  { "tablespoon",  "tbsp" },
-  { "tablespoons", "tbsp" },
-  { "tbsps",       "tbsp" },
-  { "teaspoon",    "tsp"  },
-  { "teaspoons",   "tsp"  },
-  { "tsps",        "tsp"  }
-}; // UnitSyn
-
-auto FindUnit(const std::string& unit) {
-  if (unit.empty())
-    return std::string("ea");
-  auto u = ToLower(unit);
-  auto it = UnitSyn.find(u);
-  return (it != UnitSyn.end()) ? it->second : u;
-}
+bool Contains(std::string_view str, char ch)
+{ return (str.find(ch) != std::string_view::npos); }
 
-struct Volume {
-  std::string unit;
-  double ml = 0;
-};
-
-const std::vector<Volume> Volumes = {
-  { "ml",     1 },
-  { "l",   1000 },
-  { "tsp",    4.9289 },
-  { "tbsp",  14.7868 },
-  { "floz",  29.5735 },
-  { "shot",  44.3603 },
-  { "cup",  236.5882 },
-  { "pt",   473.1765 },
-  { "qt",   946.3529 },
-  { "gal", 3785.4118 }
-}; // Volumes
-
-auto FindVolume(const std::string& unit) {
-  for (auto& it : Volumes) {
-    if (it.unit == unit)
-      return it.ml;
-  }
-  return 0.0;
-} // FindVolume
-
-struct Weight {
-  std::string unit;
-  double g = 0;
-};
-
-const std::vector<Weight> Weights = {
-  { "g",     1 },
-  { "kg", 1000 },
-  { "oz",  28.3495 },
-  { "lb", 453.5924 }
-}; // Weights
-
-auto FindWeight(const std::string& unit) {
-  for (auto& it : Weights) {
-    if (it.unit == unit)
-      return it.g;
-  }
-  return 0.0;
-} // FindWeight
+bool IsFraction(std::string_view str)
+{ return VulgarFraction(str).has_value(); }
 
-auto Ratio(const Nutrition& nutr, const std::string& unit,
-	   double value, double volume, double weight)
-{
-  if (unit == "ea" && nutr.g < 0.0)
+// A mixed number's frac is a separate word; parse through it in place.
+double Value(std::string_view value, std::string_view frac) {
+  if (!frac.empty())
+    value = std::string_view{value.data(), frac.data() + frac.size()};
+  return ParseQuantity(value).value_or(0.0);
+} // Value
+
+// An empty unit means each.
+Unit RecipeUnit(std::string_view unit)
+{ return unit.empty() ? Unit::ea : FindRecipeUnit(unit); }
+
+auto Ratio(const Nutrition& nutr, Unit unit, double value) {
+  if (unit == Unit::ea && nutr.g < 0.0)
     return value;
   if (nutr.ml != 0) {
-    if (volume != 0.0)
-      return value * volume / nutr.ml;
+    if (IsVolume(unit))
+      return Volume{value, unit}.ml / nutr.ml;
   }
   if (nutr.g != 0) {
-    if (weight != 0.0)
-      return value * weight / std::abs(nutr.g);
+    if (IsMass(unit))
+      return Mass{value, unit}.g / std::abs(nutr.g);
   }
   return 0.0;
 } // Ratio
 
+// A recipe line, as views into the text it was parsed from.
 struct Line {
-  std::string value;
-  std::string unit;
-  std::string weight;
-  std::string name;
-  void erase() {
-    value.erase();
-    unit.erase();
-    weight.erase();
-    name.erase();
-  }
+  std::string_view value;
+  std::string_view frac;     // of a mixed number, as in "1 1/2"
+  std::string_view unit;
+  std::string_view weight;
+  std::string_view name;
+  bool unit_is_name = false; // unit is not a unit but part of name
 }; // Line
 
-std::string MakeString(const Line& line) {
-  std::string rval = line.value;
+// Appends line, as it was written but with single spaces, to str.
+void AppendLine(std::string& str, const Line& line) {
+  str += line.value;
+  if (!line.frac.empty())
+    (str += ' ') += line.frac;
   if (!line.unit.empty())
-    rval += " " + line.unit;
+    (str += ' ') += line.unit;
   if (!line.weight.empty())
-    rval += " (" + line.weight + ")";
+    ((str += " (") += line.weight) += ')';
   if (!line.name.empty())
-    rval += " " + line.name;
-  return rval;
+    (str += ' ') += line.name;
+} // AppendLine
+
+std::string MakeString(const Line& line) {
+  std::string str;
+  AppendLine(str, line);
+  return str;
 } // MakeString(Line)
 
-std::ostream& operator<<(std::ostream& os, const Line& line)
-  { return os << MakeString(line); }
+constexpr auto Ws = std::string_view{" \t\n\r\f\v"};
+
+void SkipWs(std::string_view& str)
+{ str.remove_prefix(std::min(str.find_first_not_of(Ws), str.size())); }
 
-Line Parse(const std::string& str) {
+void TrimTrailingWs(std::string_view& str)
+{ str.remove_suffix(str.size() - (str.find_last_not_of(Ws) + 1)); }
+
+// Removes and returns the next whitespace-delimited word.
+std::string_view NextWord(std::string_view& str) {
+  SkipWs(str);
+  auto word = str.substr(0, str.find_first_of(Ws));
+  str.remove_prefix(word.size());
+  return word;
+} // NextWord
+
+Line Parse(std::string_view str) {
   Line line;
-  std::istringstream input(str);
-  input >> line.value;
-  if (!input)
+  line.value = NextWord(str);
+  if (line.value.empty())
     return line;
-  input >> std::ws;
-  if (input.peek() != '(') {
-    input >> line.unit;
-    if (!input)
+  SkipWs(str);
+  if (!str.starts_with('(')) {
+    line.unit = NextWord(str);
+    if (line.unit.empty())
       return line;
-    if (!ContainsAny(line.value, ".-/")
-	&& !FractionMap.contains(line.value)
-	&& !line.unit.empty())
-    {
+    if (!ContainsAny(line.value, ".-/") && !IsFraction(line.value)) {
       if (std::isdigit(line.unit[0]) && Contains(line.unit, '/')
-	|| FractionMap.contains(line.unit))
+	|| IsFraction(line.unit))
       {
-	line.value += ' ';
-	line.value += line.unit;
-	input >> line.unit;
-	if (!input)
+	line.frac = line.unit;
+	line.unit = NextWord(str);
+	if (line.unit.empty())
 	  return line;
       }
     }
-    input >> std::ws;
+    SkipWs(str);
   }
-  if (input.peek() == '(') {
-    input.ignore();
-    std::getline(input >> std::ws, line.weight, ')');
+  if (str.starts_with('(')) {
+    str.remove_prefix(1);
+    SkipWs(str);
+    auto i = std::min(str.find(')'), str.size());
+    line.weight = str.substr(0, i);
     TrimTrailingWs(line.weight);
-    input >> std::ws;
+    str.remove_prefix(std::min(i + 1, str.size()));
+    SkipWs(str);
   }
-  std::getline(input, line.name);
+  line.name = str;
   return line;
 } // Parse
 
+// Parses a weight such as "250 g" into grams, or returns 0.
+double ParseWeight(std::string_view str) {
+  SkipWs(str);
+  double v = 0.0;
+  auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), v);
+  if (ec != std::errc{})
+    return 0.0;
+  str.remove_prefix(ptr - str.data());
+  auto u = NextWord(str);
+  if (u.empty())
+    return 0.0;
+  return Mass{v, FindRecipeUnit(u)}.g;
+} // ParseWeight
+
 void NewHandler() {
   std::set_new_handler(nullptr);
   std::cerr << "Out of memory!" << std::endl;
   std::terminate();
 } // NewHandler
 
-int main() {
-  std::set_new_handler(NewHandler);
-  try {
-    NutrVec ingredients;
-    ReadIngredients(ingredients);
-    std::cout << "Read " << ingredients.size() << " ingredients." << std::endl;
-
-    int servings = 0;
-    double cookedWeight = 0.0;
-    Line line;
-    std::string buf;
-    Nutrition total;
-    std::cin.exceptions(std::cin.failbit);
-    while (std::cin) {
-      std::cin >> std::ws;
-      if (std::cin.eof())
-	break;
-      if (std::cin.peek() == '#') {
-        static const auto all = std::numeric_limits<std::streamsize>::max();
-	std::cin.ignore(all, '\n');
-	continue;
+// Receives the results of evaluating a recipe, in order: any servings
+// line, each ingredient line, and then the totals or an error.
+class ReportSink {
+public:
+  virtual ~ReportSink() = default;
+  virtual void servings(const Line& line, int servings, double cooked) = 0;
+  virtual void line(const Line& line, const Match& match) = 0;
+  virtual void totals(const Nutrition& total, int servings, double cooked) = 0;
+  virtual void error(const std::exception& x) = 0;
+}; // ReportSink
+
+// The report nut has always printed.
+class HumanReport : public ReportSink {
+  std::ostream& output;
+public:
+  explicit HumanReport(std::ostream& os) : output{os} { }
+  void servings(const Line& line, int servings, double cooked) override;
+  void line(const Line& line, const Match& match) override;
+  void totals(const Nutrition& total, int servings, double cooked) override;
+  void error(const std::exception& x) override;
+}; // HumanReport
+
+void HumanReport::servings(const Line&, int servings, double cooked) {
+  output << "servings=" << servings;
+  if (cooked)
+    output << ", cooked weight=" << std::ceil(cooked) << " g";
+  output << std::endl;
+} // servings
+
+void HumanReport::line(const Line& line, const Match& match) {
+  using std::setw;
+  const auto& nut = match.nutr;
+  {
+    PrecSaver prec(output, 1);
+    output << std::fixed
+      << "g="     << setw(6) << nut.g
+      << " kcal=" << setw(6) << nut.kcal
+      << " p="    << setw(5) << nut.prot
+      << " f="    << setw(5) << nut.fat
+      << " c="    << setw(5) << nut.carb
+      << " fb="   << setw(5) << nut.fiber
+      << std::defaultfloat
+      << " : " << line.value;
+  }
+  if (!line.frac.empty())
+    output << ' ' << line.frac;
+  if (line.unit_is_name)
+    output << ' ' << line.unit << ' ' << line.name;
+  else if (!line.unit.empty())
+    output << ' ' << line.unit;
+  if (!line.weight.empty()) {
+    output << " (";
+    if (!std::isdigit(line.weight[0])) {
+      double w = Mass{1, FindRecipeUnit(line.weight)}.g;
+      if (w == 0.0) {
+	output << line.weight << '?';
       }
-      std::getline(std::cin, buf);
-      Line line = Parse(buf);
-      { // Process servings specification.
-	auto unit = ToLower(line.unit);
-	if (unit == "serving" || unit == "servings") {
-	  if (!line.name.empty() && line.name[0] != '#') {
-	    throw std::runtime_error(
-		"Invalid servings spec: " + MakeString(line));
-	  }
-	  if (servings != 0)
-	    throw std::runtime_error("Duplicate servings: " + MakeString(line));
-	  double s = std::stod(line.value);
-	  if (s < 1 || s > 100 || std::round(s) != s) {
-	    throw std::runtime_error(
-		"Invalid number of servings: " + MakeString(line));
-	  }
-	  double w = 0.0;
-	  if (!line.weight.empty()) {
-	    std::istringstream iss(line.weight);
-	    double v = 0.0;
-	    std::string u;
-	    iss >> v >> u;
-	    w = v * FindWeight(FindUnit(u));
-	    if (w <= 0.0) {
-	      throw std::runtime_error(
-		  "Invalid serving weight: " + MakeString(line));
-	    }
-	  }
-	  servings = gsl::narrow_cast<int>(s);
-	  cookedWeight = w;
-	  std::cout << "servings=" << servings;
-	  if (cookedWeight)
-	    std::cout << ", cooked weight=" << std::ceil(cookedWeight) << " g";
-	  std::cout << std::endl;
-	  continue;
-	}
+      else {
+	PrecSaver prec(output, 3);
+	output << (nut.g / w) << ' ' << line.weight;
       }
-      auto value = Value(line.value);
-      auto unit  = FindUnit(line.unit);
-      double volume = 0.0;
-      double weight = 0.0;
-      if (unit != "ea") {
-        volume = FindVolume(unit);
-	if (volume == 0.0) {
-	  weight = FindWeight(unit);
-	  if (weight == 0.0 && line.weight.empty()) {
-	    line.name = line.unit + ' ' + line.name;
-	    unit = "ea";
-	    line.unit.clear();
-	  }
-	}
+    }
+    else {
+      output << line.weight;
+      double g = ParseWeight(line.weight);
+      if (g <= 0.0 || (100 * std::abs(nut.g-g))/g > 7) {
+	output << '?';
       }
-      std::optional<Nutrition> nutr;
-      {
-	auto name = ToLower(line.name);
-	{ // trim punctuation
-	  const auto punct = std::string("!$()*+:;<=>?@[]^{|}~");
-	  auto i = name.find_first_of(punct);
-	  if (i != std::string::npos)
-	    name.erase(i);
-	}
-	TrimTrailingWs(name);
-	if (!name.empty()) {
-	  if (Contains(name, "extra")) {
-	    static const std::regex
-				e{"\\bextra[ -](small|large|light|heavy)\\b"};
-	    name = std::regex_replace(name, e, "x$1");
-	  }
-	  nutr = FindIngredientWithPlurals(ingredients, name);
-	  if (!nutr) {
-	    // substitute common synonyms
-	    rng::replace(name, '-', ' ');
-	    static const std::regex e1{"\\b(diced|cubed)\\b"};
-	    static const std::regex e2{"\\bdry\\b"};
-	    static const std::regex e3{"\\bservings\\b"};
-	    name = std::regex_replace(name, e1, "chopped");
-	    name = std::regex_replace(name, e2, "dried");
-	    name = std::regex_replace(name, e3, "serving");
-	    nutr = FindIngredientWithPlurals(ingredients, name);
-	  }
+    }
+    output << ')';
+  }
+  if (!line.name.empty() && !line.unit_is_name)
+    output << ' ' << line.name;
+  output << std::endl;
+  if (match.missing) {
+    output << "    ?? not found";
+    const char* sep = "; did you mean: ";
+    for (auto name: match.suggestions) {
+      output << sep << name;
+      sep = ", ";
+    }
+    output << std::endl;
+  }
+} // line
+
+void HumanReport::totals(const Nutrition& total, int servings, double cooked)
+{
+  using std::setw;
+  using std::round;
+  auto nut = total;
+  output << '\n';
+  if (servings != 0) {
+    output << "Per ";
+    if (cooked != 0.0)
+      output << std::ceil(cooked/servings) << " g ";
+    output << "serving:\n\n";
+    nut.scale(1.0/servings);
+  }
+  output << setw(4) << round(nut.kcal) << " kcal\n"
+	 << setw(4) << round(nut.g)    << " g raw\n"
+	 << setw(4) << round(nut.prot) << " g protein\n"
+	 << setw(4) << round(nut.fat)  << " g fat\n"
+	 << setw(4) << round(nut.carb) << " g carb\n"
+	 << setw(4) << round(nut.fiber)<< " g fiber"
+	 << std::endl;
+} // totals
+
+void HumanReport::error(const std::exception& x) {
+  if (auto fail = dynamic_cast<const std::ios_base::failure*>(&x)) {
+    output << "ios_base::failure: " << fail->what() << '\n'
+	   << "    error code = " << fail->code().message() << std::endl;
+  }
+  else
+    output << "standard exception: " << x.what() << std::endl;
+} // error
+
+// One row per line, then "total" and, given servings, "serving" rows:
+//   recipe kind text ingredient ratio g ml kcal prot fat carb fiber alcohol
+// A line whose name was not found is followed by a "suggest" row, with
+// zero nutrition, for each name nut suggests in its place.
+class TsvReport : public ReportSink {
+  TextWriter out;
+  std::string_view recipe;
+  std::string text;
+  void row(std::string_view kind, std::string_view ingredient,
+	   double ratio, const Nutrition& nutr);
+public:
+  static constexpr std::string_view Header = "recipe\tkind\ttext\tingredient"
+	"\tratio\tg\tml\tkcal\tprot\tfat\tcarb\tfiber\talcohol\n";
+  TsvReport(std::ostream& os, std::string_view recipe_, bool header)
+    : out{os}, recipe{recipe_}
+    { if (header) out << Header; }
+  void servings(const Line& line, int servings, double cooked) override;
+  void line(const Line& line, const Match& match) override;
+  void totals(const Nutrition& total, int servings, double cooked) override;
+  void error(const std::exception& x) override;
+}; // TsvReport
+
+void TsvReport::row(std::string_view kind, std::string_view ingredient,
+		    double ratio, const Nutrition& nutr)
+{
+  out.field(recipe) << '\t' << kind << '\t';
+  out.field(text) << '\t';
+  out.field(ingredient) << '\t' << ratio
+    << '\t' << nutr.g    << '\t' << nutr.ml   << '\t' << nutr.kcal
+    << '\t' << nutr.prot << '\t' << nutr.fat  << '\t' << nutr.carb
+    << '\t' << nutr.fiber << '\t' << nutr.alcohol << '\n';
+  out.sync();
+} // row
+
+void TsvReport::servings(const Line&, int, double) { }
+
+void TsvReport::line(const Line& line, const Match& match) {
+  text.clear();
+  AppendLine(text, line);
+  row("line", match.ingredient, match.ratio, match.nutr);
+  for (auto name: match.suggestions)
+    row("suggest", name, 0.0, Nutrition{});
+} // line
+
+void TsvReport::totals(const Nutrition& total, int servings, double cooked)
+{
+  text.clear();
+  row("total", {}, 1.0, total);
+  if (servings != 0) {
+    auto nut = total;
+    nut.scale(1.0/servings);
+    text.clear();
+    (text += std::to_string(servings)) += " servings";
+    if (cooked != 0.0)
+      ((text += " (") += std::to_string(std::lround(cooked))) += " g)";
+    row("serving", {}, 1.0/servings, nut);
+  }
+  out.flush();
+} // totals
+
+void TsvReport::error(const std::exception& x) {
+  text = x.what();
+  row("error", {}, 0.0, Nutrition{});
+  out.flush();
+} // error
+
+// One JSON object per recipe, on one line:
+//   {"recipe":..., "lines":[{"text","ingredient","ratio","nutrition"}...],
+//    (a line whose name was not found also has "suggestions":[...])
+//    "total":{...}, "servings":n, "cooked_g":g, "per_serving":{...}}
+// or, if evaluation failed, "error" in place of "total" and what follows.
+class JsonReport : public ReportSink {
+  TextWriter out;
+  std::string text;
+  bool first = true;
+  void nutrition(const Nutrition& nutr);
+public:
+  JsonReport(std::ostream& os, std::string_view recipe) : out{os} {
+    out << "{\"recipe\":";
+    out.quoted(recipe) << ",\"lines\":[";
+  }
+  void servings(const Line& line, int servings, double cooked) override;
+  void line(const Line& line, const Match& match) override;
+  void totals(const Nutrition& total, int servings, double cooked) override;
+  void error(const std::exception& x) override;
+}; // JsonReport
+
+void JsonReport::nutrition(const Nutrition& nutr) {
+  out << "{\"g\":"     << nutr.g
+      << ",\"ml\":"    << nutr.ml
+      << ",\"kcal\":"  << nutr.kcal
+      << ",\"prot\":"  << nutr.prot
+      << ",\"fat\":"   << nutr.fat
+      << ",\"carb\":"  << nutr.carb
+      << ",\"fiber\":" << nutr.fiber
+      << ",\"alcohol\":" << nutr.alcohol << '}';
+} // nutrition
+
+void JsonReport::servings(const Line&, int, double) { }
+
+void JsonReport::line(const Line& line, const Match& match) {
+  if (!first)
+    out << ',';
+  first = false;
+  text.clear();
+  AppendLine(text, line);
+  out << "{\"text\":";
+  out.quoted(text) << ",\"ingredient\":";
+  if (match.ingredient.empty())
+    out << "null";
+  else
+    out.quoted(match.ingredient);
+  out << ",\"ratio\":" << match.ratio << ",\"nutrition\":";
+  nutrition(match.nutr);
+  if (match.missing) {
+    out << ",\"suggestions\":[";
+    const char* sep = "";
+    for (auto name: match.suggestions) {
+      out << sep;
+      out.quoted(name);
+      sep = ",";
+    }
+    out << ']';
+  }
+  out << '}';
+  out.sync();
+} // line
+
+void JsonReport::totals(const Nutrition& total, int servings, double cooked)
+{
+  out << "],\"total\":";
+  nutrition(total);
+  if (servings != 0) {
+    auto nut = total;
+    nut.scale(1.0/servings);
+    out << ",\"servings\":" << servings;
+    if (cooked != 0.0)
+      out << ",\"cooked_g\":" << cooked;
+    out << ",\"per_serving\":";
+    nutrition(nut);
+  }
+  out << "}\n";
+  out.flush();
+} // totals
+
+void JsonReport::error(const std::exception& x) {
+  out << "],\"error\":";
+  out.quoted(x.what()) << "}\n";
+  out.flush();
+} // error
+
+// Makes the report for format; recipe names the input in tsv and json.
+auto MakeReport(ReportFormat format, std::ostream& output,
+		std::string_view recipe, bool header = true)
+  -> std::unique_ptr<ReportSink>
+{
+  switch (format) {
+    case ReportFormat::tsv:
+      return std::make_unique<TsvReport>(output, recipe, header);
+    case ReportFormat::json:
+      return std::make_unique<JsonReport>(output, recipe);
+    default:
+      return std::make_unique<HumanReport>(output);
+  }
+} // MakeReport
+
+// Reads a recipe from input and sends its nutrition to report.
+void Evaluate(const IngredDb& ingredients,
+	      std::istream& input, ReportSink& report)
+{
+  int servings = 0;
+  double cookedWeight = 0.0;
+  std::string buf;
+  std::string name;
+  std::string synonym;
+  Nutrition total;
+  input.exceptions(input.failbit);
+  while (input) {
+    input >> std::ws;
+    if (input.eof())
+      break;
+    if (input.peek() == '#') {
+      static const auto all = std::numeric_limits<std::streamsize>::max();
+      input.ignore(all, '\n');
+      continue;
+    }
+    std::getline(input, buf);
+    Line line = Parse(buf);
+    { // Process servings specification.
+      if (IEquals(line.unit, "serving") || IEquals(line.unit, "servings")) {
+	if (!line.name.empty() && line.name[0] != '#') {
+	  throw std::runtime_error(
+	      "Invalid servings spec: " + MakeString(line));
 	}
-      }
-      if (!nutr)
-	nutr = Nutrition();
-      auto& nut = *nutr;
-      nut.scale(Ratio(nut, unit, value, volume, weight));
-      if (nut.g != 0.0)
-        nut.g = std::max(std::abs(nut.g), 0.1f);
-      using std::cout;
-      using std::setw;
-      using std::ceil;
-      using std::round;
-      {
-        PrecSaver prec(cout, 1);
-	cout << std::fixed
-	  << "g="     << setw(6) << nut.g
-	  << " kcal=" << setw(6) << nut.kcal
-	  << " p="    << setw(5) << nut.prot
-	  << " f="    << setw(5) << nut.fat
-	  << " c="    << setw(5) << nut.carb
-	  << " fb="   << setw(5) << nut.fiber
-	  << std::defaultfloat
-	  << " : " << line.value;
-      }
-      if (!line.unit.empty())
-	cout << ' ' << line.unit;
-      if (!line.weight.empty()) {
-	cout << " (";
-        if (!std::isdigit(line.weight[0])) {
-	  double w = FindWeight(FindUnit(line.weight));
-	  if (w == 0.0) {
-	    cout << line.weight << '?';
-	  }
-	  else {
-	    PrecSaver prec(cout, 3);
-	    cout << (nut.g / w) << ' ' << line.weight;
-	  }
+	if (servings != 0)
+	  throw std::runtime_error("Duplicate servings: " + MakeString(line));
+	double s = 0.0;
+	std::from_chars(line.value.data(),
+			line.value.data() + line.value.size(), s);
+	if (s < 1 || s > 100 || std::round(s) != s) {
+	  throw std::runtime_error(
+	      "Invalid number of servings: " + MakeString(line));
 	}
-	else {
-	  cout << line.weight;
-	  std::istringstream iss(line.weight);
-	  double v = 0.0;
-	  std::string u;
-	  double g = 0.0;
-	  iss >> v >> u;
-	  if (iss)
-	    g = v * FindWeight(FindUnit(u));
-	  if (g <= 0.0 || (100 * std::abs(nut.g-g))/g > 7) {
-	    cout << '?';
+	double w = 0.0;
+	if (!line.weight.empty()) {
+	  w = ParseWeight(line.weight);
+	  if (w <= 0.0) {
+	    throw std::runtime_error(
+		"Invalid serving weight: " + MakeString(line));
 	  }
 	}
-	cout << ')';
+	servings = gsl::narrow_cast<int>(s);
+	cookedWeight = w;
+	report.servings(line, servings, cookedWeight);
+	continue;
       }
-      if (!line.name.empty())
-	cout << ' ' << line.name;
-      cout << std::endl;
-      total += nut;
     }
+    auto value = Value(line.value, line.frac);
+    auto unit  = RecipeUnit(line.unit);
+    if (unit != Unit::ea && !IsVolume(unit) && !IsMass(unit)
+	&& line.weight.empty())
     {
-      using std::cout;
-      using std::setw;
-      using std::round;
-      cout << '\n';
-      if (servings != 0) {
-	cout << "Per ";
-	if (cookedWeight != 0.0)
-	  cout << std::ceil(cookedWeight/servings) << " g ";
-	cout << "serving:\n\n";
-	total.scale(1.0/servings);
+      line.unit_is_name = true;
+      unit = Unit::ea;
+    }
+    std::optional<Match> match;
+    {
+      name.clear();
+      if (line.unit_is_name) {
+	AppendLower(name, line.unit);
+	name += ' ';
+      }
+      AppendLower(name, line.name);
+      { // trim punctuation
+	const auto punct = std::string("!$()*+:;<=>?@[]^{|}~");
+	auto i = name.find_first_of(punct);
+	if (i != std::string::npos)
+	  name.erase(i);
+      }
+      TrimTrailingWs(name);
+      if (!name.empty()) {
+	ExpandExtra(name);
+	synonym = name;
+	SubstLookupSynonyms(synonym);  // substitute common synonyms
+	match = FindIngredient(ingredients, name, synonym);
+	if (!match)
+	  name.swap(synonym);  // suggest for the synonym, as before
+      }
+    }
+    if (!match) {
+      match = Match();
+      if (!name.empty()) {
+	match->missing = true;
+	for (auto i: ingredients.suggest(name, MaxSuggestions))
+	  match->suggestions.push_back(ingredients.name(i));
+      }
+    }
+    auto& nut = match->nutr;
+    match->ratio = Ratio(nut, unit, value);
+    nut.scale(match->ratio);
+    if (nut.g != 0.0)
+      nut.g = std::max(std::abs(nut.g), 0.1f);
+    report.line(line, *match);
+    total += nut;
+  }
+  report.totals(total, servings, cookedWeight);
+} // Evaluate
+
+// Evaluate, but reports an error, as main always has, and returns false
+// rather than throwing.
+bool TryEvaluate(const IngredDb& ingredients,
+		 std::istream& input, ReportSink& report)
+{
+  try {
+    Evaluate(ingredients, input, report);
+    return true;
+  }
+  catch (const std::exception& x) {
+    report.error(x);
+  }
+  return false;
+} // TryEvaluate
+
+// Answers requests on one connection until the client closes it.
+void ServeConnection(const IngredDb& ingredients, const UnixSocket& conn) {
+  try {
+    std::string request;
+    std::string reply;
+    while (conn.read(request)) {
+      std::ostringstream output;
+      auto status = UnixSocket::Status::error;
+      if (request.empty() || std::uint8_t(request[0])
+				>= std::uint8_t(ReportFormat::end))
+	output << "standard exception: bad request\n";
+      else {
+	auto format = ReportFormat(request[0]);
+	std::ispanstream input{std::string_view{request}.substr(1)};
+	if (TryEvaluate(ingredients, input, *MakeReport(format, output, "-")))
+	  status = UnixSocket::Status::ok;
       }
-      cout << setw(4) << round(total.kcal) << " kcal\n"
-	   << setw(4) << round(total.g)    << " g raw\n"
-	   << setw(4) << round(total.prot) << " g protein\n"
-	   << setw(4) << round(total.fat)  << " g fat\n"
-	   << setw(4) << round(total.carb) << " g carb\n"
-	   << setw(4) << round(total.fiber)<< " g fiber"
-	   << std::endl;
+      reply.assign(1, char(status));
+      reply += std::move(output).str();
+      conn.write(reply);
+    }
+  }
+  catch (const std::exception& x) {
+    std::cerr << "nut: " << x.what() << std::endl;
+  }
+} // ServeConnection
+
+// How many connections nut --serve answers at once; more wait to be
+// accepted until one closes.
+constexpr std::ptrdiff_t MaxConnections = 64;
+
+// Accepts connections forever, each on its own thread, at most
+// MaxConnections at a time.  The threads share ingredients and the count
+// of free slots, so they outlive main even if Serve throws.  A failure to
+// accept or to start a thread for want of descriptors, memory or threads
+// is logged and retried after a pause.
+[[noreturn]] void Serve(std::shared_ptr<const IngredDb> ingredients,
+			const std::string& path)
+{
+  const auto listener = UnixSocket::Listen(path);
+  std::cout << "Serving on " << path << std::endl;
+  auto transient = [](std::error_code ec) {
+    return ec == std::errc::too_many_files_open
+	|| ec == std::errc::too_many_files_open_in_system
+	|| ec == std::errc::no_buffer_space
+	|| ec == std::errc::not_enough_memory
+	|| ec == std::errc::resource_unavailable_try_again;
+  };
+  using Slots = std::counting_semaphore<MaxConnections>;
+  const auto slots = std::make_shared<Slots>(MaxConnections);
+  for (;;) {
+    slots->acquire();
+    try {
+      std::thread{[ingredients, slots](UnixSocket conn) {
+		    ServeConnection(*ingredients, conn);
+		    conn = UnixSocket{};  // close it before freeing its slot
+		    slots->release();
+		  }, listener.accept()}.detach();
+      continue;
     }
-    return EXIT_SUCCESS;
+    catch (const std::system_error& x) {
+      slots->release();
+      if (!transient(x.code()))
+	throw;
+      std::cerr << "nut: " << x.what() << std::endl;
+    }
+    catch (const std::bad_alloc& x) {
+      slots->release();
+      std::cerr << "nut: " << x.what() << std::endl;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
   }
-  catch (const std::ios_base::failure& fail) {
-    std::cout << "ios_base::failure: " << fail.what() << '\n'
-              << "    error code = " << fail.code().message() << std::endl;
+} // Serve
+
+// The files named by paths, and the files below any directories among
+// them in path order, skipping hidden ones.
+auto RecipeFiles(std::span<const char* const> paths) {
+  namespace fs = std::filesystem;
+  std::vector<fs::path> files;
+  for (fs::path path: paths) {
+    if (!fs::is_directory(path)) {
+      files.push_back(path);
+      continue;
+    }
+    std::vector<fs::path> found;
+    auto iter = fs::recursive_directory_iterator{path};
+    for (const auto& entry: iter) {
+      if (entry.path().filename().string().starts_with('.')) {
+	if (entry.is_directory())
+	  iter.disable_recursion_pending();
+	continue;
+      }
+      if (entry.is_regular_file())
+	found.push_back(entry.path());
+    }
+    rng::sort(found);
+    rng::move(found, std::back_inserter(files));
+  }
+  return files;
+} // RecipeFiles
+
+// Evaluates every recipe in paths on a pool of threads, each taking the
+// next unclaimed recipe, and prints the reports in order as soon as each
+// one and those before it are done.  Returns the number that failed.
+int Batch(const IngredDb& ingredients, std::span<const char* const> paths,
+	  ReportFormat format)
+{
+  struct Report {
+    std::string text;
+    bool ok = false;
+  }; // Report
+  const auto files = RecipeFiles(paths);
+  std::vector<std::promise<Report>> promises(files.size());
+  std::vector<std::future<Report>> reports;
+  reports.reserve(files.size());
+  for (auto& p: promises)
+    reports.push_back(p.get_future());
+
+  std::atomic<std::size_t> next = 0;
+  auto worker = [&]() {
+    for (std::size_t i; (i = next++) < files.size(); ) {
+      std::ostringstream output;
+      const auto name = files[i].string();
+      bool ok = false;
+      {
+	auto report = MakeReport(format, output, name, false);
+	if (auto input = std::ifstream{files[i]})
+	  ok = TryEvaluate(ingredients, input, *report);
+	else
+	  report->error(std::runtime_error{"cannot read " + name});
+      }
+      promises[i].set_value(Report{std::move(output).str(), ok});
+    }
+  };
+  auto threads = std::min<std::size_t>(
+		    std::max(std::thread::hardware_concurrency(), 1u),
+		    files.size());
+  std::vector<std::jthread> pool;
+  for (std::size_t t = 0; t != threads; ++t)
+    pool.emplace_back(worker);
+
+  const bool human = (format == ReportFormat::human);
+  if (format == ReportFormat::tsv)
+    std::cout << TsvReport::Header;
+  int failed = 0;
+  for (std::size_t i = 0; i != files.size(); ++i) {
+    auto report = reports[i].get();
+    if (human)
+      std::cout << "\n==> " << files[i].string() << " <==\n";
+    std::cout << report.text << std::flush;
+    if (!report.ok)
+      ++failed;
+  }
+  if (failed != 0) {
+    (human ? std::cout : std::cerr)
+      << '\n' << failed << " of " << files.size()
+      << " recipes failed." << std::endl;
+  }
+  return failed;
+} // Batch
+
+int main(int argc, const char* const argv[]) {
+  using namespace std::string_view_literals;
+  std::set_new_handler(NewHandler);
+  auto format = ReportFormat::human;
+  try {
+    auto args = std::span{argv, std::size_t(argc)}.subspan(1);
+    if (!args.empty() && std::string_view{args[0]}.starts_with("--format=")) {
+      auto f = ParseFormat(std::string_view{args[0]}.substr(9));
+      if (!f)
+	throw std::runtime_error(std::string{"unknown format: "} + args[0]);
+      format = *f;
+      args = args.subspan(1);
+    }
+    std::string socket;
+    if (!args.empty()) {
+      if (args[0] == "--serve"sv && args.size() <= 2)
+	socket = (args.size() == 2) ? args[1] : UnixSocket::DefaultPath();
+      else if (args[0] != "--batch"sv || args.size() < 2)
+	throw std::runtime_error("usage: nut [--format=human|tsv|json]"
+				 " [--serve [socket] | --batch path...]");
+    }
+    auto db = std::make_shared<const IngredDb>();
+    const auto& ingredients = *db;
+    if (format == ReportFormat::human || !socket.empty()) {
+      std::cout << "Read " << ingredients.size() << " ingredients."
+		<< std::endl;
+    }
 
+    if (!socket.empty())
+      Serve(std::move(db), socket);
+    if (!args.empty()) {
+      return (Batch(ingredients, args.subspan(1), format) == 0)
+	     ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    return TryEvaluate(ingredients, std::cin,
+		       *MakeReport(format, std::cout, "-"))
+	   ? EXIT_SUCCESS : EXIT_FAILURE;
   }
   catch (const std::exception& x) {
-    std::cout << "standard exception: " << x.what() << std::endl;
+    MakeReport(format, std::cout, "-")->error(x);
   }
   return EXIT_FAILURE;
 } // main
@@ -0,0 +1,51 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+
+// Client for nut --serve: sends the recipe on stdin to the server and
+// prints its report, as nut would, without loading the ingredients.
+
+#include "ReportFormat.h"
+#include "Socket.h"
+
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <span>
+#include <stdexcept>
+#include <cstdlib>
+
+int main(int argc, const char* const argv[]) {
+  try {
+    auto args = std::span{argv, std::size_t(argc)}.subspan(1);
+    auto format = ReportFormat::human;
+    if (!args.empty() && std::string_view{args[0]}.starts_with("--format=")) {
+      auto f = ParseFormat(std::string_view{args[0]}.substr(9));
+      if (!f)
+	throw std::runtime_error(std::string{"unknown format: "} + args[0]);
+      format = *f;
+      args = args.subspan(1);
+    }
+    if (args.size() > 1)
+      throw std::runtime_error(
+	  "usage: nutc [--format=human|tsv|json] [socket]");
+    const auto path = !args.empty() ? std::string{args[0]}
+				    : UnixSocket::DefaultPath();
+    auto request = std::string(1, char(format));
+    request.append(std::istreambuf_iterator<char>{std::cin},
+		   std::istreambuf_iterator<char>{});
+    const auto server = UnixSocket::Connect(path);
+    server.write(request);
+    std::string reply;
+    if (!server.read(reply) || reply.empty())
+      throw std::runtime_error(path + ": no reply");
+    std::cout.write(reply.data() + 1, reply.size() - 1);
+    std::cout.flush();
+    if (reply[0] != char(UnixSocket::Status::ok))
+      return EXIT_FAILURE;
+    return EXIT_SUCCESS;
+  }
+  catch (const std::exception& x) {
+    std::cout << "standard exception: " << x.what() << std::endl;
+  }
+  return EXIT_FAILURE;
+} // main
@@ -0,0 +1,119 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+
+#include "NutQuery.h"
+#include "IngredDb.h"
+
+#include <gsl/gsl>
+
+#include <string>
+#include <string_view>
+#include <span>
+#include <optional>
+#include <iostream>
+#include <charconv>
+#include <cstdlib>
+
+namespace {
+
+// Appends x as the shortest text that reads back as the same float.
+void AppendFloat(std::string& out, float x) {
+  char buf[32];
+  auto end = std::to_chars(buf, buf + sizeof(buf), x).ptr;
+  out.append(buf, end);
+} // AppendFloat
+
+} // local
+
+int main(int argc, const char* const argv[]) {
+  using std::cout;
+  try {
+    auto args = std::span{argv + 1, argv + argc};
+    std::string db_path;
+    std::optional<std::string> by_text;
+    bool ascending = false;
+    std::size_t top = 20;
+    bool usage = false;
+    for (; !args.empty() && std::string_view{args[0]}.starts_with("--");
+	 args = args.subspan(1))
+    {
+      const std::string_view opt = args[0];
+      if (opt.starts_with("--by=")) {
+	by_text = opt.substr(5);
+      }
+      else if (opt == "--asc") {
+	ascending = true;
+      }
+      else if (opt.starts_with("--db=")) {
+	db_path = opt.substr(5);
+      }
+      else if (opt.starts_with("--top=")) {
+	auto n = opt.substr(6);
+	auto [end, ec] = std::from_chars(n.data(), n.data() + n.size(), top);
+	usage |= (ec != std::errc{} || end != n.data() + n.size());
+      }
+      else {
+	usage = true;
+      }
+    }
+    if (usage) {
+      std::cerr << "usage: nutq [--by=EXPR [--asc]] [--top=N] [--db=FILE]"
+	" [predicate...]\n"
+	"Lists the ingred.dat records for which the predicate holds, e.g.\n"
+	"  nutq --by=prot/kcal 'fiber/carb > 0.3 and kcal/g < 1.5'\n"
+	"as TSV: the N (20; 0 for all) with the greatest value of --by (the"
+	" least,\nwith --asc), or else the first N in name order.  "
+	"Expressions use g ml kcal\nprot fat carb fiber alcohol, numbers, "
+	"+ - * /, < <= > >= == !=, and or not,\nand parentheses.\n";
+      return EXIT_FAILURE;
+    }
+    std::string where_text;
+    for (std::string_view arg: args) {
+      if (!where_text.empty())
+	where_text.push_back(' ');
+      where_text.append(arg);
+    }
+    std::optional<NutExpr> where, by;
+    if (!where_text.empty())
+      where.emplace(where_text);
+    if (by_text)
+      by.emplace(*by_text);
+
+    const auto db = IngredDb{db_path.empty() ? IngredDb::DefaultPath()
+					     : db_path};
+    const auto table = NutTable{db};
+    const auto hits = SelectRows(table, where ? &*where : nullptr,
+				 by ? &*by : nullptr, top, ascending);
+
+    std::string out = "name";
+    if (by)
+      (out += '\t') += by->text();
+    for (auto field: NutFieldNames)
+      (out += '\t') += field;
+    out += '\n';
+    for (const auto& hit: hits) {
+      out += db.name(hit.row);
+      if (by) {
+	out += '\t';
+	AppendFloat(out, hit.value);
+      }
+      for (std::size_t f = 0; f != std::size_t(NutField::end); ++f) {
+	out += '\t';
+	AppendFloat(out, table.column(NutField(f))[hit.row]);
+      }
+      out += '\n';
+    }
+    cout << out << std::flush;
+
+    return EXIT_SUCCESS;
+  }
+  catch (const std::ios::failure& fail) {
+    cout << "ios::failure: " << fail.what()
+              << "\n    error code = " << fail.code().message() << std::endl;
+
+  }
+  catch (const std::exception& x) {
+    cout << "standard exception: " << x.what() << std::endl;
+  }
+
+  return EXIT_FAILURE;
+} // main
@@ -0,0 +1,164 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+
+// Times ParseQuantity against nut's old Value() on common quantities.
+
+#include "Quantity.h"
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <span>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <charconv>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+
+namespace old {
+
+bool ContainsAny(std::string_view str1, std::string_view str2)
+{ return (str1.find_first_of(str2) != std::string_view::npos); }
+
+bool Contains(std::string_view str, char ch)
+{ return (str.find(ch) != std::string_view::npos); }
+
+const std::map<std::string, std::string, std::less<>> FractionMap = {
+  { "¼", "1/4" },
+  { "½", "1/2" },
+  { "¾", "3/4" },
+  { "⅓", "1/3" },
+  { "⅔", "2/3" },
+  { "⅛", "1/8" },
+  { "⅜", "3/8" },
+  { "⅝", "5/8" },
+  { "⅞", "7/8" }
+}; // FractionMap
+
+std::string SubstFraction(const std::string& str) {
+  if (str.empty())
+    return str;
+  for (const auto& s: FractionMap) {
+    auto i = str.find(s.first);
+    if (i == std::string::npos)
+      continue;
+    std::string rval;
+    if (i != 0) {
+      rval = str.substr(0, i);
+      if (std::isdigit(str[i-1]))
+	rval += ' ';
+    }
+    rval += s.second;
+    i += s.first.size();
+    if (i < str.size() && std::isdigit(str[i]))
+      rval += ' ';
+    return rval += str.substr(i);
+  }
+  return str;
+} // SubstFraction
+
+double Value(std::string_view arg) {
+  if (arg.empty())
+    return 0;
+  auto str = SubstFraction(std::string{arg});
+  if (Contains(str, '.') || !ContainsAny(str, "-/ ")) {
+    std::size_t pos = 0;
+    double rval = 0.0;
+    try { rval = std::stod(str, &pos); }
+    catch (...) { return 0; }
+    if (pos != str.size())
+      return 0;
+    return rval;
+  }
+  std::istringstream iss(str);
+  int base = 0;
+  iss >> base;
+  if (!iss || base < 0)
+    return 0;
+  switch (iss.peek()) {
+    case '/': {
+      iss.ignore();
+      int den = 0;
+      iss >> den;
+      if (!iss || !iss.eof() || den <= base)
+	return 0;
+      return double(base) / den;
+    }
+    case ' ':
+    case '-':
+      iss.ignore();
+      break;
+    default:
+      return 0;
+  }
+  int num = 0;
+  iss >> num;
+  if (!iss || num <= 0 || iss.peek() != '/')
+    return 0;
+  iss.ignore();
+  int den = 0;
+  iss >> den;
+  if (!iss || den <= num || !iss.eof())
+    return 0;
+  return base + double(num) / den;
+} // Value
+
+} // old
+
+namespace {
+
+constexpr std::string_view Common[] = {
+  "1", "2", "1/2", "1 1/2", "½", "1½", "0.5", "2.25", "3", "1/4", "1-1/2",
+  "¾", "4", "1/3", "12", "1.5"
+};
+
+using Clock = std::chrono::steady_clock;
+
+// Seconds to parse count quantities with parse, summing them into total.
+template<class Parse>
+double Time(std::size_t count, Parse parse, double& total) {
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i != count; ++i)
+    total += parse(Common[i % std::size(Common)]);
+  return std::chrono::duration<double>(Clock::now() - start).count();
+} // Time
+
+} // local
+
+int main(int argc, const char* const argv[]) {
+  using std::cout;
+  try {
+    auto args = std::span{argv + 1, argv + argc};
+    std::size_t count = 1'000'000;
+    if (!args.empty()) {
+      std::string_view n = args[0];
+      auto [end, ec] = std::from_chars(n.data(), n.data() + n.size(), count);
+      if (args.size() != 1 || ec != std::errc{} || end != n.data() + n.size()) {
+	std::cerr << "usage: quantity_bench [count]\n";
+	return EXIT_FAILURE;
+      }
+    }
+
+    double total = 0.0, old_total = 0.0;
+    const auto now = Time(count, [](std::string_view str)
+			    { return ParseQuantity(str).value_or(0.0); }, total);
+    const auto was = Time(count, [](std::string_view str)
+			    { return old::Value(str); }, old_total);
+    cout << std::fixed << std::setprecision(3)
+	 << count << " quantities: " << now << " s, old " << was << " s ("
+	 << std::setprecision(1) << was / now << "x)" << std::endl;
+    if (std::abs(total - old_total) > 1e-6 * old_total) {
+      cout << "quantity_bench: total " << total << ", old " << old_total
+	   << std::endl;
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  }
+  catch (const std::exception& x) {
+    cout << "standard exception: " << x.what() << std::endl;
+  }
+
+  return EXIT_FAILURE;
+} // main
@@ -0,0 +1,239 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+
+// Compares ParseQuantity with nut's old Value() on every string of up to
+// four tokens drawn from numbers, fractions, separators and junk.  Where
+// both accept a string they must agree.  Only the old parser may accept
+// signs, hex, exponents and infinities, which stod or >> let through.
+// The forms only ParseQuantity accepts are checked against expected
+// values.
+
+#include "Quantity.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <sstream>
+#include <iostream>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+
+namespace old {
+
+bool ContainsAny(std::string_view str1, std::string_view str2)
+{ return (str1.find_first_of(str2) != std::string_view::npos); }
+
+bool Contains(std::string_view str, char ch)
+{ return (str.find(ch) != std::string_view::npos); }
+
+const std::map<std::string, std::string, std::less<>> FractionMap = {
+  { "¼", "1/4" },
+  { "½", "1/2" },
+  { "¾", "3/4" },
+  { "⅓", "1/3" },
+  { "⅔", "2/3" },
+  { "⅛", "1/8" },
+  { "⅜", "3/8" },
+  { "⅝", "5/8" },
+  { "⅞", "7/8" }
+}; // FractionMap
+
+std::string SubstFraction(const std::string& str) {
+  if (str.empty())
+    return str;
+  for (const auto& s: FractionMap) {
+    auto i = str.find(s.first);
+    if (i == std::string::npos)
+      continue;
+    std::string rval;
+    if (i != 0) {
+      rval = str.substr(0, i);
+      if (std::isdigit(str[i-1]))
+	rval += ' ';
+    }
+    rval += s.second;
+    i += s.first.size();
+    if (i < str.size() && std::isdigit(str[i]))
+      rval += ' ';
+    return rval += str.substr(i);
+  }
+  return str;
+} // SubstFraction
+
+double Value(std::string_view arg) {
+  if (arg.empty())
+    return 0;
+  auto str = SubstFraction(std::string{arg});
+  if (Contains(str, '.') || !ContainsAny(str, "-/ ")) {
+    std::size_t pos = 0;
+    double rval = 0.0;
+    try { rval = std::stod(str, &pos); }
+    catch (...) { return 0; }
+    if (pos != str.size())
+      return 0;
+    return rval;
+  }
+  std::istringstream iss(str);
+  int base = 0;
+  iss >> base;
+  if (!iss || base < 0)
+    return 0;
+  switch (iss.peek()) {
+    case '/': {
+      iss.ignore();
+      int den = 0;
+      iss >> den;
+      if (!iss || !iss.eof() || den <= base)
+	return 0;
+      return double(base) / den;
+    }
+    case ' ':
+    case '-':
+      iss.ignore();
+      break;
+    default:
+      return 0;
+  }
+  int num = 0;
+  iss >> num;
+  if (!iss || num <= 0 || iss.peek() != '/')
+    return 0;
+  iss.ignore();
+  int den = 0;
+  iss >> den;
+  if (!iss || den <= num || !iss.eof())
+    return 0;
+  return base + double(num) / den;
+} // Value
+
+} // old
+
+namespace {
+
+constexpr std::string_view Tokens[] = {
+  "0", "1", "2", "3", "4", "8", "16", "100",
+  "¼", "½", "¾", "⅓", "⅔", "⅛", "⅞", "⅕",
+  " ", "-", "/", ".", "\t",
+  "+", "e", "x", "a", "1e3", "0x1", "inf", ","
+};
+
+// Signs, hex, exponents and infinities, which only the old parser accepts.
+bool OldOnly(std::string_view str, double value) {
+  const auto first = str.find_first_not_of(" \t");
+  return value < 0 || std::isinf(value)
+      || (first != std::string_view::npos && str[first] == '-')
+      || str.find_first_of("+eExXpP") != std::string_view::npos;
+} // OldOnly
+
+// Ranges, the rest of the U+2150 fractions, and blanks after '/' or a
+// mixed number's '-', which the old parser rejected or lacked, and the
+// near misses ParseQuantity must still reject.
+struct Expected {
+  std::string_view str;
+  std::optional<double> value;
+}; // Expected
+
+const Expected NewForms[] = {
+  { "2-3", 2.5 },           { " 2-3 ", 2.5 },        { "2.5-3", 2.75 },
+  { "1/2-1", 0.75 },        { "½-¾", 0.625 },        { "1½-2", 1.75 },
+  { "1-1/2-2", 1.75 },      { "1 1/2-2 1/2", 2.0 },  { "⅐", 1.0 / 7 },
+  { "⅑", 1.0 / 9 },         { "⅒", 0.1 },            { "⅕", 0.2 },
+  { "⅖", 0.4 },             { "⅗", 0.6 },            { "⅘", 0.8 },
+  { "⅙", 1.0 / 6 },         { "⅚", 5.0 / 6 },        { "1⅙", 1 + 1.0 / 6 },
+  { "2 ⅚", 2 + 5.0 / 6 },   { "3-⅕", 3.2 },          { "1/ 2", 0.5 },
+  { "1/\t4", 0.25 },        { "1 1/ 2", 1.5 },       { "1- ½", 1.5 },
+  { "1-\t1/2", 1.5 },       { "3-2", std::nullopt }, { "2-2", std::nullopt },
+  { "2-", std::nullopt },   { "-2", std::nullopt },  { "2- 3", std::nullopt },
+  { "2-3-4", std::nullopt }, { "3/2", std::nullopt }, { "1/0", std::nullopt },
+  { "1 /2", std::nullopt }, { "+1", std::nullopt },  { "1e3", std::nullopt },
+  { "0x1", std::nullopt },  { "inf", std::nullopt }, { "⅟", std::nullopt }
+}; // NewForms
+
+bool CheckExpected() {
+  bool ok = true;
+  for (const auto& [str, value]: NewForms) {
+    const auto now = ParseQuantity(str);
+    if (now.has_value() == value.has_value()
+	&& (!now || std::abs(*now - *value) <= 1e-12))
+      continue;
+    std::cout << '"' << str << "\": " << (now ? std::to_string(*now) : "none")
+	      << ", expected " << (value ? std::to_string(*value) : "none")
+	      << '\n';
+    ok = false;
+  }
+  return ok;
+} // CheckExpected
+
+struct Counts {
+  long cases = 0;
+  long both = 0;      // accepted by both, with the same value
+  long old_only = 0;  // signs, hex, exponents and infinities
+  long new_only = 0;  // ranges, and fractions the old map lacked
+  long failed = 0;
+}; // Counts
+
+void Check(const std::string& str, Counts& counts) {
+  ++counts.cases;
+  const auto was = old::Value(str);
+  const auto now = ParseQuantity(str);
+  if (now && was != 0.0) {
+    if (std::abs(*now - was) <= 1e-12 * std::max(1.0, std::abs(was))) {
+      ++counts.both;
+      return;
+    }
+  }
+  else if (was != 0.0) {
+    if (OldOnly(str, was)) {
+      ++counts.old_only;
+      return;
+    }
+  }
+  else {
+    counts.new_only += (now && *now != 0.0);
+    return;
+  }
+  if (++counts.failed <= 20) {
+    std::cout << '"' << str << "\": " << (now ? std::to_string(*now) : "none")
+	      << ", old " << was << '\n';
+  }
+} // Check
+
+void Enumerate(std::string& str, int tokens, Counts& counts) {
+  Check(str, counts);
+  if (tokens == 0)
+    return;
+  const auto size = str.size();
+  for (auto token: Tokens) {
+    str += token;
+    Enumerate(str, tokens - 1, counts);
+    str.resize(size);
+  }
+} // Enumerate
+
+} // local
+
+int main() {
+  using std::cout;
+  try {
+    const bool expected = CheckExpected();
+    Counts counts;
+    std::string str;
+    Enumerate(str, 4, counts);
+    cout << "quantity_test: " << counts.cases << " cases, " << counts.both
+	 << " agree, " << counts.old_only << " old only, " << counts.new_only
+	 << " new only, " << std::size(NewForms) << " new forms";
+    if (counts.failed != 0 || !expected) {
+      cout << ", FAILED" << std::endl;
+      return EXIT_FAILURE;
+    }
+    cout << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch (const std::exception& x) {
+    cout << "standard exception: " << x.what() << std::endl;
+  }
+
+  return EXIT_FAILURE;
+} // main
@@ -0,0 +1,108 @@
+// Copyright 2026 Terry Golubiewski, all rights reserved.
+
+#include "MacroProfiles.h"
+#include "IngredDb.h"
+
+#include <gsl/gsl>
+
+#include <string>
+#include <string_view>
+#include <span>
+#include <iostream>
+#include <iomanip>
+#include <charconv>
+#include <stdexcept>
+#include <cstdlib>
+
+namespace {
+
+void PrintRow(std::ostream& out, double distance,
+	      const MacroProfiles::Profile& p, std::string_view name)
+{
+  using std::setw;
+  out << std::fixed << std::setprecision(2)
+      << setw(6) << distance << ' ' << setw(7) << p[0] << ' ' << setw(7)
+      << p[1] << ' ' << setw(7) << p[2] << ' ' << setw(7) << p[3]
+      << "  " << name << '\n';
+} // PrintRow
+
+} // local
+
+int main(int argc, const char* const argv[]) {
+  using std::cout;
+  try {
+    auto args = std::span{argv + 1, argv + argc};
+    auto basis = ProfileBasis::kcal;
+    std::size_t top = 10;
+    bool usage = false;
+    for (; !args.empty() && std::string_view{args[0]}.starts_with("--");
+	 args = args.subspan(1))
+    {
+      const std::string_view opt = args[0];
+      if (opt.starts_with("--per=")) {
+	auto b = ParseBasis(opt.substr(6));
+	usage |= !b;
+	basis = b.value_or(basis);
+      }
+      else if (opt.starts_with("--top=")) {
+	auto n = opt.substr(6);
+	auto [end, ec] = std::from_chars(n.data(), n.data() + n.size(), top);
+	usage |= (ec != std::errc{} || end != n.data() + n.size());
+      }
+      else {
+	usage = true;
+      }
+    }
+    if (args.empty() || usage) {
+      std::cerr << "usage: substitute [--per=kcal|g] [--top=N] name...\n"
+	"Lists the N (10) ingred.dat ingredients whose protein, fat, carb "
+	"and fiber,\nper 100 kcal (or per gram), are nearest the named "
+	"one's, nearest first.\nDistances are in standard deviations of "
+	"each macro over ingred.dat.\n";
+      return EXIT_FAILURE;
+    }
+    std::string name;
+    for (std::string_view arg: args) {
+      if (!name.empty())
+	name.push_back(' ');
+      name.append(arg);
+    }
+
+    const auto db = IngredDb{};
+    const auto i = db.lookup(name);
+    if (!i) {
+      std::string what = "not in ingred.dat: " + name;
+      const char* sep = "; did you mean: ";
+      for (auto s: db.suggest(name, 3)) {
+	(what += sep) += db.name(s);
+	sep = ", ";
+      }
+      throw std::runtime_error{what};
+    }
+    const auto profiles = MacroProfiles{db, basis};
+    const auto per = std::string{"per "}
+	+ ((basis == ProfileBasis::kcal) ? "100 kcal" : "g");
+    if (!profiles.has(*i))
+      throw std::runtime_error{std::string{db.name(*i)} + " has no " + per};
+
+    cout << "  dist    prot     fat    carb   fiber  " << per << '\n';
+    PrintRow(cout, 0.0, profiles.profile(*i), db.name(*i));
+    for (const auto& n: profiles.nearest(*i, top)) {
+      PrintRow(cout, n.distance, profiles.profile(n.ingredient),
+	       db.name(n.ingredient));
+    }
+    cout << std::flush;
+
+    return EXIT_SUCCESS;
+  }
+  catch (const std::ios::failure& fail) {
+    cout << "ios::failure: " << fail.what()
+              << "\n    error code = " << fail.code().message() << std::endl;
+
+  }
+  catch (const std::exception& x) {
+    cout << "standard exception: " << x.what() << std::endl;
+  }
+
+  return EXIT_FAILURE;
+} // main
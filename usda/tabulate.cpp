@@ -3,6 +3,8 @@
 #include "../src/Parse.h"
 #include "../src/Atwater.h"
 #include "../src/To.h"
+#include "../src/Units.h"
+#include "../src/FoodDb.h"
 
 #include <gsl/gsl>
 
@@ -461,35 +463,23 @@ void ProcessNutrients(std::vector<Ingred>& foods) {
   std::cout << "Wrote " << foods.size() << " foods to " << outname << ".\n";
 } // ProcessNutrients
 
-constexpr float Cup = 236.6;
-
-const std::map<std::string, float> FactorMap = {
-  { "cup",         Cup     },
-  { "tablespoon",  Cup/16  },
-  { "tbsp",        Cup/16  },
-  { "Tablespoons", Cup/16  },
-  { "teaspoon",    Cup/48  },
-  { "tsp",         Cup/48  },
-  { "liter",       1000.0  },
-  { "milliliter",  1.0     },
-  { "ml",          1.0     },
-  { "cubic inch",  16.39   },
-  { "cubic centimeter", 1.0 },
-  { "cc",              1.0 },
-  { "gallon",     16 * Cup },
-  { "pint",        2 * Cup },
-  { "fl oz",       Cup / 8 },
-  { "floz",        Cup / 8 },
-  { "quart",       4 * Cup }
-}; // FactorMap
-
-float ConversionFactor(const std::string& unit) {
-  if (unit.empty())
+float ConversionFactor(std::string_view unit)
+{ return float(Volume{1, FindUnit(unit)}.ml); }
+
+// If str starts with a volume unit, returns its ml per unit and removes
+// it, with any following ',' and spaces, from str.
+float StripVolumeUnit(std::string_view& str) {
+  auto [unit, len] = FindUnitPrefix(str);
+  if (!IsVolume(unit))
     return 0.0f;
-  if (auto iter = FactorMap.find(unit); iter != FactorMap.end())
-    return iter->second;
-  return 0.0f;
-} // ConversionFactor
+  str.remove_prefix(len);
+  if (!str.empty() && str[0] == ',')
+    str.remove_prefix(1);
+  auto pos = str.find_first_not_of(" ");
+  if (pos != std::string_view::npos)
+    str.remove_prefix(pos);
+  return float(Volume{1, unit}.ml);
+} // StripVolumeUnit
 
 void ProcessPortions(const std::vector<Ingred>& foods) {
   std::cout << "Processing portions.\n";
@@ -606,19 +596,10 @@ void ProcessPortions(const std::vector<Ingred>& foods) {
 	}
 	else {
 	  auto m = std::string_view{modifier};
-	  for (const auto& [unit, factor]: FactorMap) {
-	    if (m.starts_with(unit)) {
-	      ml = val * factor;
-	      val = 0.0f;
-	      m.remove_prefix(unit.size());
-	      if (!m.empty() && m[0] == ',')
-	        m.remove_prefix(1);
-	      auto pos = m.find_first_not_of(" ");
-	      if (pos != std::string_view::npos)
-	        m.remove_prefix(pos);
-	      modifier = std::string(m);
-	      break;
-	    }
+	  if (auto factor = StripVolumeUnit(m)) {
+	    ml = val * factor;
+	    val = 0.0f;
+	    modifier = std::string(m);
 	  }
 	}
       }
@@ -635,18 +616,8 @@ void ProcessPortions(const std::vector<Ingred>& foods) {
 	    if (pos != std::string_view::npos)
 	      d.remove_prefix(pos);
 	  }
-	  for (const auto& [unit, factor]: FactorMap) {
-	    if (d.starts_with(unit)) {
-	      ml = value * factor;
-	      d.remove_prefix(unit.size());
-	      if (!d.empty() && d[0] == ',')
-	        d.remove_prefix(1);
-	      auto pos = d.find_first_not_of(" ");
-	      if (pos != std::string_view::npos)
-	        d.remove_prefix(pos);
-	      break;
-	    }
-	  }
+	  if (auto factor = StripVolumeUnit(d))
+	    ml = value * factor;
 	  if (ml == 0.0f)
 	    d = std::string_view{v[Idx::desc]};
 	}
@@ -707,19 +678,127 @@ void ProcessPortions(const std::vector<Ingred>& foods) {
   }
 } // ProcessPortions
 
+// Writes usda_foods.bin, for lookup, from the foods and portions as they
+// were written to (and will be read from) usda_foods.tsv and
+// usda_portions.tsv.  Portions are kept by food, in the order lookup lists
+// them.
+void WriteFoodDb() {
+  struct Portion {
+    int fdc_id = 0;
+    float g  = 0.0f;
+    float ml = 0.0f;
+    std::string desc;
+    std::string comment;
+    auto operator<=>(const Portion&) const = default;
+  }; // Portion
+  std::vector<Portion> portions;
+  std::string line;
+  {
+    enum class Idx { fdc_id, g, ml, desc, comment, end };
+    static const std::array<std::string_view, int(Idx::end)> Headings = {
+      "fdc_id",
+      "g",
+      "ml",
+      "desc",
+      "comment"
+    }; // Headings
+    const auto fname = DbPath + "usda_portions.tsv";
+    auto input = std::ifstream{fname};
+    if (!input)
+      throw std::runtime_error{"Cannot open " + fname};
+    if (!std::getline(input, line))
+      throw std::runtime_error{"Cannot read " + fname};
+    ParseVec<Idx> v;
+    ParseTsv(v, line);
+    CheckHeadings(v, Headings);
+    int linenum = 1;
+    while (std::getline(input, line)) {
+      ++linenum;
+      try {
+	ParseTsv(v, line);
+	portions.push_back(Portion{To<int>(v[Idx::fdc_id]),
+				   To<float>(v[Idx::g]), To<float>(v[Idx::ml]),
+				   v[Idx::desc], v[Idx::comment]});
+      }
+      catch (const std::exception& x) {
+	std::cerr << fname << '(' << linenum << ") " << x.what() << '\n';
+      }
+    }
+    rng::sort(portions);
+  }
+  FoodDbWriter db;
+  {
+    enum class Idx
+	{ fdc_id, kcal, prot, fat, carb, fiber, alc, atwater, desc, end };
+    static const std::array<std::string_view, int(Idx::end)> Headings = {
+      "fdc_id",
+      "kcal",
+      "prot",
+      "fat",
+      "carb",
+      "fiber",
+      "alc",
+      "atwater",
+      "desc"
+    }; // Headings
+    const auto fname = DbPath + "usda_foods.tsv";
+    auto input = std::ifstream{fname};
+    if (!input)
+      throw std::runtime_error{"Cannot open " + fname};
+    if (!std::getline(input, line))
+      throw std::runtime_error{"Cannot read " + fname};
+    ParseVec<Idx> v;
+    ParseTsv(v, line);
+    CheckHeadings(v, Headings);
+    int linenum = 1;
+    while (std::getline(input, line)) {
+      ++linenum;
+      try {
+	ParseTsv(v, line);
+	FoodRecord food;
+	food.fdc_id  = To<int>(v[Idx::fdc_id]);
+	food.kcal    = To<float>(v[Idx::kcal]);
+	food.protein = To<float>(v[Idx::prot]);
+	food.fat     = To<float>(v[Idx::fat]);
+	food.carb    = To<float>(v[Idx::carb]);
+	food.fiber   = To<float>(v[Idx::fiber]);
+	food.alcohol = To<float>(v[Idx::alc]);
+	db.add(food, v[Idx::atwater], v[Idx::desc]);
+	auto r = rng::equal_range(portions, int(food.fdc_id), {},
+				  &Portion::fdc_id);
+	for (const auto& p: r)
+	  db.add_portion(p.g, p.ml, p.desc, p.comment);
+      }
+      catch (const std::exception& x) {
+	std::cerr << fname << '(' << linenum << ") " << x.what() << '\n';
+      }
+    }
+  }
+  const auto outname = DbPath + "usda_foods.bin";
+  db.write(outname);
+  std::cout << "Wrote " << db.size() << " foods to " << outname << ".\n";
+} // WriteFoodDb
+
 void NewHandler() {
   std::set_new_handler(nullptr);
   std::cerr << "Out of memory!" << std::endl;
   std::terminate();
 } // NewHandler
 
-int main() {
+int main(int argc, char* argv[]) {
   std::set_new_handler(NewHandler);
   DefaultCoutFlags = std::cout.flags();
+
+  // tabulate --bin: only rebuild usda_foods.bin from the .tsv files.
+  if (argc == 2 && argv[1] == std::string{"--bin"}) {
+    WriteFoodDb();
+    return 0;
+  }
   std::cout << "Starting..." << std::endl;
 
   auto foods = GetFoods();
   ProcessNutrients(foods);
   ProcessPortions(foods);
+  WriteFoodDb();
   return 0;
 } // main